@@ -2,6 +2,7 @@
 #ifndef FG_INC_QUEUE
 #define FG_INC_QUEUE
 #include <queue>
+#include <algorithm>
 
 /**
  * Wrapper around the std::queue container with additional functions for
@@ -71,5 +72,22 @@ public:
         while (!this->empty())
             this->pop();
     }
+
+    /**
+     * Remove all elements matching the predicate and restore the heap property,
+     * single pass - O(N) instead of popping and pushing back every element.
+     * @return Number of removed elements
+     */
+    template <typename Predicate>
+    typename TSequence::size_type remove_if(Predicate predicate)
+    {
+        auto it = ::std::remove_if(this->c.begin(), this->c.end(), predicate);
+        const auto count = static_cast<typename TSequence::size_type>(::std::distance(it, this->c.end()));
+        if (!count)
+            return 0;
+        this->c.erase(it, this->c.end());
+        ::std::make_heap(this->c.begin(), this->c.end(), this->comp);
+        return count;
+    }
 };
 #endif //> FG_INC_QUEUE
\ No newline at end of file
@@ -0,0 +1,178 @@
+#pragma once
+#ifndef FG_INC_EVENT_DISPATCH_TABLE
+#define FG_INC_EVENT_DISPATCH_TABLE
+
+#include <event/EventDefinitions.hpp>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+
+namespace event
+{
+    /**
+     * @brief Flat table of slots indexed directly with the event type code. Standard event
+     * types are dense so the lookup is a single indexed load instead of a tree search.
+     * The table is split into fixed size chunks that are allocated on first use and never
+     * moved or released until clear() - pointers to slots stay valid. The standard range
+     * is allocated up front, the remaining chunks form the extension area for custom event
+     * types (up to MAX_DENSE_CODES), codes above that land in a sparse fallback map.
+     *
+     * The structure itself is not thread safe for writers - the owner is responsible for
+     * locking. Lookups of already allocated slots only read published chunk pointers.
+     */
+    template <typename TSlotType>
+    class DispatchTable
+    {
+    public:
+        using self_type = DispatchTable<TSlotType>;
+        using slot_type = TSlotType;
+        using size_type = std::size_t;
+
+        /// Number of slots in a single chunk (power of two)
+        static const size_type CHUNK_SIZE = 64;
+        /// Maximum number of chunks, codes in [0, MAX_DENSE_CODES) are directly indexed
+        static const size_type MAX_CHUNKS = 1024;
+        static const size_type MAX_DENSE_CODES = CHUNK_SIZE * MAX_CHUNKS;
+        /// Number of slots covering all standard event types
+        static const size_type STANDARD_CODES = static_cast<size_type>(Type::LastStandardEventCode) + 1;
+
+    protected:
+        struct Chunk
+        {
+            std::array<slot_type, CHUNK_SIZE> slots;
+            /// Bit set for every slot that was requested for writing (see forEach)
+            uint64_t usedMask;
+
+            Chunk() : slots(), usedMask(0) {}
+        }; //# struct Chunk
+
+    public:
+        DispatchTable() : m_chunks(), m_sparse()
+        {
+            for (auto &chunk : m_chunks)
+                chunk.store(nullptr, std::memory_order_relaxed);
+            for (size_type idx = 0; idx * CHUNK_SIZE < STANDARD_CODES; idx++)
+                m_chunks[idx].store(new Chunk(), std::memory_order_release);
+        }
+
+        ~DispatchTable()
+        {
+            for (auto &chunk : m_chunks)
+                delete chunk.exchange(nullptr);
+        }
+
+        DispatchTable(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+    public:
+        static inline bool isDense(Type eventCode) noexcept { return static_cast<size_type>(eventCode) < MAX_DENSE_CODES; }
+
+        /**
+         * Find the slot for a given event type without allocating anything.
+         * @return Pointer to the slot or nullptr if the slot was never requested
+         */
+        slot_type *find(Type eventCode)
+        {
+            const auto code = static_cast<size_type>(eventCode);
+            if (code < MAX_DENSE_CODES)
+            {
+                auto pChunk = m_chunks[code / CHUNK_SIZE].load(std::memory_order_acquire);
+                if (!pChunk)
+                    return nullptr;
+                return &pChunk->slots[code % CHUNK_SIZE];
+            }
+            auto found = m_sparse.find(eventCode);
+            if (found == m_sparse.end())
+                return nullptr;
+            return &found->second;
+        }
+
+        slot_type const *find(Type eventCode) const { return const_cast<self_type *>(this)->find(eventCode); }
+
+        /**
+         * Get the slot for a given event type, allocates the chunk (or the sparse entry)
+         * when needed.
+         */
+        slot_type &at(Type eventCode)
+        {
+            const auto code = static_cast<size_type>(eventCode);
+            if (code < MAX_DENSE_CODES)
+            {
+                auto &chunkPtr = m_chunks[code / CHUNK_SIZE];
+                auto pChunk = chunkPtr.load(std::memory_order_acquire);
+                if (!pChunk)
+                {
+                    pChunk = new Chunk();
+                    chunkPtr.store(pChunk, std::memory_order_release);
+                }
+                pChunk->usedMask |= (uint64_t(1) << (code % CHUNK_SIZE));
+                return pChunk->slots[code % CHUNK_SIZE];
+            }
+            return m_sparse[eventCode];
+        }
+
+        inline slot_type &operator[](Type eventCode) { return at(eventCode); }
+
+        /**
+         * Call the function for every slot that was ever requested: fn(Type, slot_type &).
+         * Iteration stops early when the function returns true.
+         * @return True if the iteration was stopped by the function
+         */
+        template <typename Function>
+        bool forEach(Function &&function)
+        {
+            for (size_type chunkIdx = 0; chunkIdx < MAX_CHUNKS; chunkIdx++)
+            {
+                auto pChunk = m_chunks[chunkIdx].load(std::memory_order_acquire);
+                if (!pChunk || !pChunk->usedMask)
+                    continue;
+                for (size_type idx = 0; idx < CHUNK_SIZE; idx++)
+                {
+                    if (!(pChunk->usedMask & (uint64_t(1) << idx)))
+                        continue;
+                    if (function(static_cast<Type>(chunkIdx * CHUNK_SIZE + idx), pChunk->slots[idx]))
+                        return true;
+                }
+            } //# for each chunk
+            for (auto &it : m_sparse)
+            {
+                if (function(it.first, it.second))
+                    return true;
+            }
+            return false;
+        }
+
+        /**
+         * Reset all slots to the default value - chunks stay allocated. Shared pointer
+         * slots are reset atomically (lookups load them with atomic_load).
+         */
+        void clear(void)
+        {
+            for (auto &chunk : m_chunks)
+            {
+                auto pChunk = chunk.load(std::memory_order_acquire);
+                if (!pChunk)
+                    continue;
+                for (auto &slot : pChunk->slots)
+                    resetSlot(slot);
+                pChunk->usedMask = 0;
+            }
+            m_sparse.clear();
+        }
+
+    protected:
+        template <typename TValueType>
+        static inline void resetSlot(std::shared_ptr<TValueType> &slot) { std::atomic_store(&slot, std::shared_ptr<TValueType>()); }
+        template <typename TValueType>
+        static inline void resetSlot(TValueType &slot) { slot = TValueType(); }
+
+    private:
+        std::array<std::atomic<Chunk *>, MAX_CHUNKS> m_chunks;
+        /// Fallback for event codes outside of the dense range
+        std::map<Type, slot_type> m_sparse;
+    }; //# class DispatchTable
+} //> namespace event
+
+#endif //> FG_INC_EVENT_DISPATCH_TABLE
@@ -0,0 +1,209 @@
+#pragma once
+#ifndef FG_INC_EVENT_AWAIT
+#define FG_INC_EVENT_AWAIT
+
+#include <event/EventManager.hpp>
+#include <util/Timesys.hpp>
+
+#if defined(FG_EVENT_COROUTINES)
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <utility>
+
+namespace event
+{
+    /**
+     * @brief Free lists of coroutine frames rounded up to size classes. Frames of the
+     * same coroutine function always have the same size, so after the first run the
+     * frames are recycled instead of going through the global allocator. Lists are per
+     * thread - no synchronization, a frame released on another thread moves there.
+     */
+    class CoroutineFramePool
+    {
+    public:
+        static constexpr std::size_t GRANULARITY = 64;
+        static constexpr std::size_t NUM_CLASSES = 32;
+        /// Maximum number of cached frames per size class (per thread)
+        static constexpr std::size_t MAX_CACHED = 64;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock *next;
+        }; //# struct FreeBlock
+
+        struct FreeLists
+        {
+            std::array<FreeBlock *, NUM_CLASSES> heads;
+            std::array<std::size_t, NUM_CLASSES> counts;
+
+            FreeLists() : heads(), counts() {}
+            ~FreeLists()
+            {
+                for (auto head : heads)
+                {
+                    while (head)
+                        ::operator delete(std::exchange(head, head->next));
+                }
+            }
+        }; //# struct FreeLists
+
+        static FreeLists &lists(void)
+        {
+            thread_local FreeLists freeLists;
+            return freeLists;
+        }
+
+    public:
+        static void *allocate(std::size_t size)
+        {
+            const auto sizeClass = (size + GRANULARITY - 1) / GRANULARITY;
+            if (!sizeClass || sizeClass > NUM_CLASSES)
+                return ::operator new(size);
+            auto &freeLists = lists();
+            auto &head = freeLists.heads[sizeClass - 1];
+            if (!head)
+                return ::operator new(sizeClass * GRANULARITY);
+            freeLists.counts[sizeClass - 1]--;
+            return std::exchange(head, head->next);
+        }
+
+        static void release(void *ptr, std::size_t size) noexcept
+        {
+            const auto sizeClass = (size + GRANULARITY - 1) / GRANULARITY;
+            if (!ptr || !sizeClass || sizeClass > NUM_CLASSES)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+            auto &freeLists = lists();
+            if (freeLists.counts[sizeClass - 1] >= MAX_CACHED)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+            auto pBlock = static_cast<FreeBlock *>(ptr);
+            pBlock->next = freeLists.heads[sizeClass - 1];
+            freeLists.heads[sizeClass - 1] = pBlock;
+            freeLists.counts[sizeClass - 1]++;
+        }
+    }; //# class CoroutineFramePool
+    //#-----------------------------------------------------------------------------------
+
+    /**
+     * @brief Fire and forget coroutine - starts immediately and runs until the first
+     * co_await, the rest is resumed by the event manager inside processEventsAndTimers.
+     * The frame is destroyed when the coroutine finishes (or when the manager is
+     * destroyed while it's suspended). Exceptions must not escape the coroutine.
+     */
+    class Task
+    {
+    public:
+        struct promise_type
+        {
+            Task get_return_object(void) noexcept { return Task(); }
+            std::suspend_never initial_suspend(void) noexcept { return {}; }
+            std::suspend_never final_suspend(void) noexcept { return {}; }
+            void return_void(void) noexcept {}
+            void unhandled_exception(void) noexcept { std::terminate(); }
+
+            static void *operator new(std::size_t size) { return CoroutineFramePool::allocate(size); }
+            static void operator delete(void *ptr, std::size_t size) noexcept { CoroutineFramePool::release(ptr, size); }
+        }; //# struct promise_type
+    }; //# class Task
+    //#-----------------------------------------------------------------------------------
+
+    /**
+     * @brief Base for awaiters resumed by the manager - the waiter node is a part of the
+     * awaiter, which lives in the coroutine frame (nothing is allocated per co_await)
+     */
+    class WaiterAwaitable : protected EventWaiter
+    {
+    protected:
+        explicit WaiterAwaitable(EventManager *pManager) : EventWaiter{nullptr, &onResume, &onCancel, 0},
+                                                          m_pManager(pManager),
+                                                          m_handle(),
+                                                          m_pEvent(nullptr) {}
+
+        static void onResume(EventWaiter *self, EventCombined *pEvent)
+        {
+            auto pAwaitable = static_cast<WaiterAwaitable *>(self);
+            pAwaitable->m_pEvent = pEvent;
+            pAwaitable->m_handle.resume();
+        }
+
+        static void onCancel(EventWaiter *self) { static_cast<WaiterAwaitable *>(self)->m_handle.destroy(); }
+
+    protected:
+        EventManager *m_pManager;
+        std::coroutine_handle<> m_handle;
+        EventCombined *m_pEvent;
+    }; //# class WaiterAwaitable
+
+    /**
+     * @brief co_await nextEvent(pManager, Type::ResourceCreated) - suspends until the next
+     * event of the type is dispatched. Returns the event structure (null if the event
+     * was thrown without it), valid until the coroutine suspends again.
+     */
+    class NextEventAwaitable : public WaiterAwaitable
+    {
+    public:
+        NextEventAwaitable(EventManager *pManager, Type eventCode) : WaiterAwaitable(pManager),
+                                                                     m_eventCode(eventCode) {}
+
+        bool await_ready(void) const noexcept { return !m_pManager; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_handle = handle;
+            // may be resumed on the processing thread before this returns
+            m_pManager->addEventWaiter(m_eventCode, this);
+        }
+
+        EventCombined *await_resume(void) const noexcept { return m_pEvent; }
+
+    private:
+        Type m_eventCode;
+    }; //# class NextEventAwaitable
+
+    /**
+     * @brief co_await sleepFor(pManager, ms) - suspends until the deadline passes, the
+     * coroutine is resumed by processTimers() (no timer entry nor callback is created)
+     */
+    class SleepAwaitable : public WaiterAwaitable
+    {
+    public:
+        SleepAwaitable(EventManager *pManager, int64_t deadlineTs) : WaiterAwaitable(pManager)
+        {
+            deadline = deadlineTs;
+        }
+
+        bool await_ready(void) const noexcept { return !m_pManager || deadline <= timesys::ticks(); }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            m_handle = handle;
+            m_pManager->addSleepWaiter(this);
+        }
+
+        void await_resume(void) const noexcept {}
+    }; //# class SleepAwaitable
+
+    inline NextEventAwaitable nextEvent(EventManager *pManager, Type eventCode)
+    {
+        return NextEventAwaitable(pManager, eventCode);
+    }
+
+    inline SleepAwaitable sleepFor(EventManager *pManager, int milliseconds)
+    {
+        return SleepAwaitable(pManager, timesys::ticks() + milliseconds);
+    }
+} //> namespace event
+
+#endif //> FG_EVENT_COROUTINES
+
+#endif //> FG_INC_EVENT_AWAIT
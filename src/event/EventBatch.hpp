@@ -0,0 +1,117 @@
+#pragma once
+#ifndef FG_INC_EVENT_BATCH
+#define FG_INC_EVENT_BATCH
+
+#include <event/EventManager.hpp>
+
+#include <vector>
+
+namespace event
+{
+    /**
+     * @brief Builder for a block of events thrown at once. Events are collected locally
+     * (no synchronization at all) and moved into the queue with a single reservation on
+     * commit. Event structures are requested from the manager's pool and passed as the
+     * first argument of the event - the caller only fills them in.
+     *
+     * The builder is meant to be used by a single producer thread. Events that were not
+     * committed are released on destruction.
+     */
+    class EventBatch
+    {
+    public:
+        using self_type = EventBatch;
+        using size_type = std::size_t;
+
+    public:
+        explicit EventBatch(EventManager *pManager, size_type reserve = 0) : m_pManager(pManager),
+                                                                            m_events(),
+                                                                            m_structs()
+        {
+            m_events.reserve(reserve);
+        }
+
+        ~EventBatch() { discard(); }
+
+        EventBatch(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+    public:
+        inline size_type size(void) const noexcept { return m_events.size(); }
+
+        inline bool empty(void) const noexcept { return m_events.empty(); }
+
+        /**
+         * Add the event with the arguments wrapped in place (same as throwEvent)
+         */
+        template <typename... Args>
+        self_type &add(Type eventCode, Args &&...args)
+        {
+            m_events.emplace_back(eventCode);
+            (m_events.back().args.push(util::WrappedValue::wrapInPlace(args)), ...);
+            return *this;
+        }
+
+        /**
+         * Request the event structure and add the event with the structure as the only
+         * argument.
+         * @return Pointer to the structure to fill in (null if there's no manager)
+         */
+        EventCombined *emplace(Type eventCode)
+        {
+            if (!m_pManager)
+                return nullptr;
+            auto pStruct = reinterpret_cast<EventCombined *>(m_pManager->requestEventStruct(eventCode));
+            add(eventCode, pStruct);
+            return pStruct;
+        }
+
+        /**
+         * Request 'count' event structures of the same type in bulk and add an event for
+         * each one of them.
+         * @return List of structures to fill in (valid until the next call)
+         */
+        EventsPtrVec const &emplace(Type eventCode, size_type count)
+        {
+            m_structs.clear();
+            if (!m_pManager || !count)
+                return m_structs;
+            m_pManager->requestEventStructs(eventCode, count, m_structs);
+            m_events.reserve(m_events.size() + m_structs.size());
+            for (auto pStruct : m_structs)
+                add(eventCode, pStruct);
+            return m_structs;
+        }
+
+        /**
+         * Throw all collected events (single enqueue) and clear the builder
+         * @return True if all events were accepted (see EventManager::throwEvent)
+         */
+        bool commit(void)
+        {
+            if (!m_pManager || m_events.empty())
+                return true;
+            const auto status = m_pManager->throwEvents(m_events.data(), m_events.size());
+            m_events.clear(); // capacity is retained
+            return status;
+        }
+
+        /**
+         * Drop all collected events - event structures go back to the pool
+         */
+        void discard(void)
+        {
+            if (m_pManager)
+                m_pManager->discardEvents(m_events.data(), m_events.size());
+            m_events.clear();
+        }
+
+    private:
+        EventManager *m_pManager;
+        std::vector<ThrownEvent> m_events;
+        /// Structures requested by the last bulk emplace
+        EventsPtrVec m_structs;
+    }; //# class EventBatch
+} //> namespace event
+
+#endif //> FG_INC_EVENT_BATCH
@@ -0,0 +1,449 @@
+#include <BuildConfig.hpp>
+#include <event/EventBridge.hpp>
+#include <event/EventManager.hpp>
+
+#include <magic_enum.hpp>
+
+#include <cstring>
+#include <new>
+
+#if defined(FG_USING_PLATFORM_LINUX)
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace event
+{
+    namespace bridge
+    {
+        inline constexpr uint32_t MAGIC = 0x42474746; // 'FGGB'
+        inline constexpr uint32_t VERSION = 1;
+
+        /**
+         * Header of the shared segment. Positions are bounded MPMC ring style - every
+         * slot has a sequence number, producers (any process) reserve the tail with CAS,
+         * the only consumer is the owner of the segment.
+         */
+        struct SharedHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t capacity;
+            /// sizeof(EventCombined) of the build that created the segment
+            uint32_t structSize;
+            alignas(64) std::atomic<uint64_t> tail;
+            alignas(64) std::atomic<uint64_t> head;
+            /// Futex word - bumped on every publish
+            alignas(64) std::atomic<uint32_t> signal;
+            /// Non zero while the consumer waits on the futex
+            std::atomic<uint32_t> sleeping;
+        }; //# struct SharedHeader
+
+        struct SharedSlot
+        {
+            std::atomic<uint64_t> sequence;
+            uint32_t eventCode;
+            uint32_t reserved;
+            uint8_t payload[sizeof(EventCombined)];
+        }; //# struct SharedSlot
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared ring needs address free atomics");
+        static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared ring needs address free atomics");
+
+        inline SharedHeader *header(void *memory) { return static_cast<SharedHeader *>(memory); }
+
+        inline SharedSlot *slots(void *memory)
+        {
+            return reinterpret_cast<SharedSlot *>(static_cast<uint8_t *>(memory) + sizeof(SharedHeader));
+        }
+
+        inline std::size_t segmentSize(uint32_t capacity) { return sizeof(SharedHeader) + sizeof(SharedSlot) * capacity; }
+
+        /// Offset of the plain data inside of EventCombined (the union with all events)
+        inline std::size_t payloadOffset(const EventCombined *pStruct)
+        {
+            return static_cast<std::size_t>(reinterpret_cast<const uint8_t *>(&pStruct->eventType) - reinterpret_cast<const uint8_t *>(pStruct));
+        }
+
+        /**
+         * Clear the pointer fields (menu names, gui action, custom data) of the copied
+         * payload - they point into the address space of the process that threw the event
+         * @param payload Copy of the plain data of the event
+         * @param event   Source of the copy (field positions)
+         */
+        inline void stripPointers(uint8_t *payload, const EventCombined &event)
+        {
+            const auto base = reinterpret_cast<const uint8_t *>(&event.eventType);
+            auto clear = [payload, base](const void *field)
+            { std::memset(payload + (static_cast<const uint8_t *>(field) - base), 0, sizeof(void *)); };
+            switch (event.eventType)
+            {
+            case Type::MenuChanged:
+                clear(&event.menuChanged.prevMenuName);
+                clear(&event.menuChanged.nextMenuName);
+                break;
+            case Type::GuiAction:
+                clear(&event.guiAction.action);
+                break;
+            case Type::Reserved1:
+            case Type::Reserved2:
+            case Type::Reserved3:
+                clear(&event.reserved.data1);
+                clear(&event.reserved.data2);
+                clear(&event.reserved.data3);
+                break;
+            default:
+                // custom and registered types carry EventCustom
+                if (event.eventType == Type::CustomEvent || event.eventType > Type::LastStandardEventCode)
+                    clear(&event.custom.ptr);
+                break;
+            }
+        }
+
+        inline std::string segmentName(std::string_view name)
+        {
+            std::string result("/fg-events-");
+            result.append(name.data(), name.size());
+            return result;
+        }
+
+#if defined(FG_USING_PLATFORM_LINUX)
+        inline void futexWake(std::atomic<uint32_t> *word)
+        {
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+        }
+
+        inline void futexWait(std::atomic<uint32_t> *word, uint32_t expected, int timeoutMs)
+        {
+            struct timespec ts;
+            ts.tv_sec = timeoutMs / 1000;
+            ts.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000L;
+            // not FUTEX_PRIVATE - the word is shared between processes
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+        }
+#endif
+
+        /**
+         * Copy the event into the ring
+         * @return False if the ring is full
+         */
+        bool push(void *memory, const EventCombined &event)
+        {
+            auto pHeader = header(memory);
+            const uint64_t mask = pHeader->capacity - 1;
+            auto pos = pHeader->tail.load(std::memory_order_relaxed);
+            SharedSlot *pSlot = nullptr;
+            while (true)
+            {
+                pSlot = &slots(memory)[pos & mask];
+                const auto sequence = pSlot->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+                if (diff == 0)
+                {
+                    if (pHeader->tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return false; // full
+                }
+                else
+                {
+                    pos = pHeader->tail.load(std::memory_order_relaxed);
+                }
+            }
+            const auto offset = payloadOffset(&event);
+            pSlot->eventCode = static_cast<uint32_t>(event.eventType);
+            std::memcpy(pSlot->payload, reinterpret_cast<const uint8_t *>(&event) + offset, sizeof(EventCombined) - offset);
+            stripPointers(pSlot->payload, event);
+            pSlot->sequence.store(pos + 1, std::memory_order_release);
+            pHeader->signal.fetch_add(1, std::memory_order_seq_cst);
+#if defined(FG_USING_PLATFORM_LINUX)
+            if (pHeader->sleeping.load(std::memory_order_seq_cst))
+                futexWake(&pHeader->signal);
+#endif
+            return true;
+        }
+
+        /**
+         * Slot at the head of the ring if it was published (consumer only)
+         */
+        SharedSlot *front(void *memory)
+        {
+            auto pHeader = header(memory);
+            const auto pos = pHeader->head.load(std::memory_order_relaxed);
+            auto pSlot = &slots(memory)[pos & (pHeader->capacity - 1)];
+            if (pSlot->sequence.load(std::memory_order_acquire) != pos + 1)
+                return nullptr;
+            return pSlot;
+        }
+
+        void pop(void *memory, SharedSlot *pSlot)
+        {
+            auto pHeader = header(memory);
+            const auto pos = pHeader->head.load(std::memory_order_relaxed);
+            pSlot->sequence.store(pos + pHeader->capacity, std::memory_order_release);
+            pHeader->head.store(pos + 1, std::memory_order_relaxed);
+        }
+    } //> namespace bridge
+} //> namespace event
+
+event::EventBridge::EventBridge(EventManager *pManager) : m_pManager(pManager),
+                                                          m_inbox(),
+                                                          m_peers(),
+                                                          m_forwarded(),
+                                                          m_mutex(),
+                                                          m_sent(0),
+                                                          m_received(0),
+                                                          m_dropped(0),
+                                                          m_rejected(0) {}
+//>---------------------------------------------------------------------------------------
+
+event::EventBridge::~EventBridge()
+{
+    close();
+}
+//>---------------------------------------------------------------------------------------
+
+bool event::EventBridge::mapSegment(Segment &segment, bool create, size_type size)
+{
+#if defined(FG_USING_PLATFORM_LINUX)
+    if (create)
+        ::shm_unlink(segment.name.c_str()); // leftover of a crashed process
+    const int flags = create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR;
+    const int fd = ::shm_open(segment.name.c_str(), flags, 0600);
+    if (fd < 0)
+        return false;
+    if (create && ::ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        ::close(fd);
+        ::shm_unlink(segment.name.c_str());
+        return false;
+    }
+    if (!create)
+    {
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<size_type>(info.st_size) < sizeof(bridge::SharedHeader))
+        {
+            ::close(fd);
+            return false;
+        }
+        size = static_cast<size_type>(info.st_size);
+    }
+    auto memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd); // mapping keeps the segment alive
+    if (memory == MAP_FAILED)
+    {
+        if (create)
+            ::shm_unlink(segment.name.c_str());
+        return false;
+    }
+    segment.memory = memory;
+    segment.size = size;
+    segment.owner = create;
+    return true;
+#else
+    return false;
+#endif
+} //> mapSegment(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventBridge::unmapSegment(Segment &segment)
+{
+#if defined(FG_USING_PLATFORM_LINUX)
+    if (segment.memory)
+        ::munmap(segment.memory, segment.size);
+    if (segment.owner)
+        ::shm_unlink(segment.name.c_str());
+#endif
+    segment.memory = nullptr;
+    segment.size = 0;
+    segment.owner = false;
+} //> unmapSegment(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventBridge::open(std::string_view name, uint32_t capacity)
+{
+    if (isOpen() || name.empty() || !capacity)
+        return false;
+    uint32_t rounded = 1;
+    while (rounded < capacity)
+        rounded <<= 1;
+    m_inbox.name = bridge::segmentName(name);
+    if (!mapSegment(m_inbox, true, bridge::segmentSize(rounded)))
+        return false;
+    // Fresh segment is zero filled - only the header fields and sequences are set
+    auto pHeader = new (m_inbox.memory) bridge::SharedHeader();
+    pHeader->capacity = rounded;
+    pHeader->structSize = static_cast<uint32_t>(sizeof(EventCombined));
+    pHeader->version = bridge::VERSION;
+    pHeader->tail.store(0, std::memory_order_relaxed);
+    pHeader->head.store(0, std::memory_order_relaxed);
+    pHeader->signal.store(0, std::memory_order_relaxed);
+    pHeader->sleeping.store(0, std::memory_order_relaxed);
+    auto pSlots = bridge::slots(m_inbox.memory);
+    for (uint32_t idx = 0; idx < rounded; idx++)
+        new (&pSlots[idx].sequence) std::atomic<uint64_t>(idx);
+    // published last - peers check the magic before using the segment
+    std::atomic_thread_fence(std::memory_order_release);
+    pHeader->magic = bridge::MAGIC;
+    return true;
+} //> open(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventBridge::connect(std::string_view peerName)
+{
+    if (peerName.empty())
+        return false;
+    Segment peer;
+    peer.name = bridge::segmentName(peerName);
+    if (!mapSegment(peer, false, 0))
+        return false;
+    auto pHeader = bridge::header(peer.memory);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (pHeader->magic != bridge::MAGIC || pHeader->version != bridge::VERSION ||
+        pHeader->structSize != sizeof(EventCombined) ||
+        peer.size < bridge::segmentSize(pHeader->capacity))
+    {
+        unmapSegment(peer); // not ready yet or a different build
+        return false;
+    }
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_peers.push_back(std::move(peer));
+    return true;
+} //> connect(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventBridge::close(void)
+{
+    std::vector<Type> forwarded;
+    /* lock mutex */ {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto &it : m_forwarded)
+            forwarded.push_back(it.first);
+    }
+    for (auto eventCode : forwarded)
+        stopForwarding(eventCode);
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &peer : m_peers)
+        unmapSegment(peer);
+    m_peers.clear();
+    unmapSegment(m_inbox);
+} //> close(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventBridge::forward(Type eventCode)
+{
+    if (!m_pManager)
+        return false;
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_forwarded.find(eventCode) != m_forwarded.end())
+        return false;
+    auto pCallback = m_pManager->addCallback(eventCode, &EventBridge::onLocalEvent, this); //! Lock - event binds
+    if (!pCallback)
+        return false;
+    m_forwarded[eventCode] = pCallback;
+    return true;
+} //> forward(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventBridge::stopForwarding(Type eventCode)
+{
+    util::Callback *pCallback = nullptr;
+    /* lock mutex */ {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        auto found = m_forwarded.find(eventCode);
+        if (found == m_forwarded.end())
+            return false;
+        pCallback = found->second;
+        m_forwarded.erase(found);
+    }
+    if (m_pManager)
+        m_pManager->deleteCallback(eventCode, pCallback); //! Lock - event binds
+    return true;
+} //> stopForwarding(...)
+//>---------------------------------------------------------------------------------------
+
+unsigned int event::EventBridge::send(const EventCombined &event)
+{
+    unsigned int count = 0;
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &peer : m_peers)
+    {
+        if (bridge::push(peer.memory, event))
+            count++;
+        else
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_sent.fetch_add(count, std::memory_order_relaxed);
+    return count;
+} //> send(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventBridge::onLocalEvent(EventCombined *pEvent)
+{
+    // received from a peer - not sent back
+    if (!pEvent || pEvent->remote)
+        return true;
+    send(*pEvent);
+    return true;
+} //> onLocalEvent(...)
+//>---------------------------------------------------------------------------------------
+
+event::EventBridge::size_type event::EventBridge::pump(void)
+{
+    if (!isOpen() || !m_pManager)
+        return 0;
+    size_type count = 0;
+    while (auto pSlot = bridge::front(m_inbox.memory))
+    {
+        // the slot comes from another process - never trust the code
+        const auto eventCode = static_cast<Type>(pSlot->eventCode);
+        const bool known = eventCode != Type::Invalid &&
+                           (magic_enum::enum_contains<Type>(eventCode) || m_pManager->isRegisteredEventType(eventCode));
+        auto pStruct = known ? reinterpret_cast<EventCombined *>(m_pManager->requestEventStruct(eventCode)) : nullptr;
+        if (!pStruct)
+        {
+            bridge::pop(m_inbox.memory, pSlot);
+            m_rejected.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        const auto offset = bridge::payloadOffset(pStruct);
+        std::memcpy(reinterpret_cast<uint8_t *>(pStruct) + offset, pSlot->payload, sizeof(EventCombined) - offset);
+        bridge::pop(m_inbox.memory, pSlot);
+        pStruct->eventType = eventCode;
+        // stripped by the sender already - pointers from another process are never kept
+        bridge::stripPointers(reinterpret_cast<uint8_t *>(&pStruct->eventType), *pStruct);
+        pStruct->identifier = EventCombined::autoid(); // fresh identity in this process
+        pStruct->remote = true;
+        m_pManager->throwEvent(eventCode, pStruct);
+        count++;
+    }
+    m_received.fetch_add(count, std::memory_order_relaxed);
+    return count;
+} //> pump(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventBridge::wait(int timeoutMs)
+{
+    if (!isOpen())
+        return false;
+    if (bridge::front(m_inbox.memory))
+        return true;
+#if defined(FG_USING_PLATFORM_LINUX)
+    auto pHeader = bridge::header(m_inbox.memory);
+    const auto signal = pHeader->signal.load(std::memory_order_acquire);
+    pHeader->sleeping.store(1, std::memory_order_seq_cst);
+    // checked again after announcing the sleep - a publish in between bumps the word
+    if (!bridge::front(m_inbox.memory))
+        bridge::futexWait(&pHeader->signal, signal, timeoutMs);
+    pHeader->sleeping.store(0, std::memory_order_relaxed);
+#endif
+    return bridge::front(m_inbox.memory) != nullptr;
+} //> wait(...)
+//>---------------------------------------------------------------------------------------
@@ -0,0 +1,138 @@
+#pragma once
+#ifndef FG_INC_EVENT_BRIDGE
+#define FG_INC_EVENT_BRIDGE
+
+#include <event/EventHelper.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace event
+{
+    class EventManager;
+
+    /**
+     * @brief Exchange of events between processes running on the same machine through
+     * shared memory. Every bridge owns an inbox - a bounded lock-free ring of fixed size
+     * slots in a named shared memory segment (shm_open/mmap). Peers connect to the inbox
+     * by name and write into it directly, the receiving side is woken up with a futex
+     * placed in the segment.
+     *
+     * Local events of the forwarded types are sent to all peers after they were
+     * dispatched locally, received events are thrown into the local manager by pump(),
+     * so subscribers don't need to know where the event came from. Only the plain data
+     * of EventCombined travels (same layout as in EventRecorder) - both sides have to run
+     * the same build. Pointer fields (menu names, gui action, custom/reserved data) are
+     * stripped - the peer receives null. Received events are marked as remote and not
+     * forwarded back, slots with unknown event types are discarded.
+     *
+     * Available on Linux only - on other platforms open/connect fail.
+     */
+    class EventBridge
+    {
+    public:
+        using self_type = EventBridge;
+        using size_type = std::size_t;
+
+        static constexpr uint32_t DEFAULT_CAPACITY = 1024;
+
+        /// Opaque shared memory mapping (layout is private to the implementation)
+        struct Segment
+        {
+            std::string name;
+            void *memory;
+            size_type size;
+            bool owner;
+
+            Segment() : name(), memory(nullptr), size(0), owner(false) {}
+        }; //# struct Segment
+
+    public:
+        explicit EventBridge(EventManager *pManager);
+        ~EventBridge();
+
+        EventBridge(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+    public:
+        /**
+         * Create the inbox of this process (segment is replaced if it already exists)
+         * @param capacity Number of slots (rounded up to the power of two)
+         */
+        bool open(std::string_view name, uint32_t capacity = DEFAULT_CAPACITY);
+        /**
+         * Open the inbox of another process - forwarded events are sent to all peers
+         */
+        bool connect(std::string_view peerName);
+        /**
+         * Stop forwarding, disconnect from peers and remove the inbox
+         */
+        void close(void);
+
+        inline bool isOpen(void) const noexcept { return m_inbox.memory != nullptr; }
+
+        inline size_type numPeers(void) const noexcept { return m_peers.size(); }
+
+        /**
+         * Forward local events of the type to the peers
+         */
+        bool forward(Type eventCode);
+        bool stopForwarding(Type eventCode);
+
+        /**
+         * Send the event to all peers (pointer fields are sent as null)
+         * @return Number of peers that accepted the event (inbox was not full)
+         */
+        unsigned int send(const EventCombined &event);
+
+        /**
+         * Throw all events waiting in the inbox into the local manager - call every
+         * frame (before processEvents)
+         * @return Number of received events
+         */
+        size_type pump(void);
+
+        /**
+         * Block until the inbox is not empty or the timeout expires (for a dedicated
+         * receiving thread)
+         * @return True if there's something to pump
+         */
+        bool wait(int timeoutMs);
+
+        inline uint64_t sentCount(void) const noexcept { return m_sent.load(std::memory_order_relaxed); }
+
+        inline uint64_t receivedCount(void) const noexcept { return m_received.load(std::memory_order_relaxed); }
+
+        /// Events that were not delivered because the peer inbox was full
+        inline uint64_t droppedCount(void) const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+        /// Received slots that were discarded - unknown event type or no free structure
+        inline uint64_t rejectedCount(void) const noexcept { return m_rejected.load(std::memory_order_relaxed); }
+
+    protected:
+        /// Target of the callbacks bound to the forwarded types
+        bool onLocalEvent(EventCombined *pEvent);
+
+        static bool mapSegment(Segment &segment, bool create, size_type size);
+        static void unmapSegment(Segment &segment);
+
+    private:
+        EventManager *m_pManager;
+        Segment m_inbox;
+        std::vector<Segment> m_peers;
+        /// Callbacks bound to the forwarded event types
+        std::unordered_map<Type, util::Callback *> m_forwarded;
+        std::mutex m_mutex;
+        std::atomic<uint64_t> m_sent;
+        std::atomic<uint64_t> m_received;
+        std::atomic<uint64_t> m_dropped;
+        std::atomic<uint64_t> m_rejected;
+    }; //# class EventBridge
+} //> namespace event
+
+#endif //> FG_INC_EVENT_BRIDGE
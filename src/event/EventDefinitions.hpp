@@ -5,6 +5,8 @@
 #include <event/KeyVirtualCodes.hpp>
 #include <util/Handle.hpp>
 
+#include <atomic>
+
 //
 // This file will contain all basic events occurring in the game engine
 // also defines standard event structures holding info about the event
@@ -155,7 +157,8 @@ namespace event
     struct EventBase : public util::ObjectWithIdentifier
     {
     private:
-        inline static uint64_t s_autoid = 0;
+        /// Atomic - event structures can be requested from any thread
+        inline static std::atomic<uint64_t> s_autoid{0};
 
     public:
         Type eventType;
@@ -386,6 +389,8 @@ namespace event
             Requested
         } status;
         resource::ResourceHandle handle;
+        /// Type of the resource (resource::ResourceType)
+        unsigned int resourceType;
 
         const char *getStatusAsString(void) const
         {
@@ -497,7 +502,7 @@ namespace event
 
     struct EventCombined : public util::ObjectWithIdentifier
     {
-        EventCombined(Type type) : eventType(type), timeStamp(timesys::ticks()), identifier(EventCombined::autoid())
+        EventCombined(Type type) : remote(false), eventType(type), timeStamp(timesys::ticks()), identifier(EventCombined::autoid())
         {
             swipe.xStart = 0;
             swipe.yStart = 0;
@@ -516,6 +521,7 @@ namespace event
         }
         inline void setup(Type type)
         {
+            remote = false;
             eventType = type;
             timeStamp = timesys::ticks();
             identifier = event::EventCombined::autoid();
@@ -530,6 +536,9 @@ namespace event
         }
         inline uint64_t getIdentifier(void) const override { return identifier; }
         inline static uint64_t autoid(void) { return EventBase::autoid(); }
+        /// Set for events received from another process (EventBridge) - these are not
+        /// forwarded back. Not a part of the plain payload (declared before the union).
+        bool remote;
         union
         {
             struct
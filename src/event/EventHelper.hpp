@@ -7,21 +7,414 @@
 #include <event/EventDefinitions.hpp>
 #include <event/ThrownEvent.hpp>
 #include <event/TimerEntryInfo.hpp>
+#include <event/DispatchTable.hpp>
 
+#include <array>
 #include <map>
+#include <unordered_map>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <vector>
 
 #include <Queue.hpp>
+#include <util/MpscQueue.hpp>
+#include <util/SlabPool.hpp>
+#include <util/Histogram.hpp>
+
+// Coroutine awaitables (EventAwait.hpp) are enabled project wide with USING_COROUTINES,
+// the waiter support in the manager is compiled only then - same layout in all targets
+#if defined(FG_USING_COROUTINES)
+#if !defined(__cpp_impl_coroutine) || !defined(__has_include)
+#error "FG_USING_COROUTINES requires a compiler with C++20 coroutines support"
+#elif !__has_include(<coroutine>)
+#error "FG_USING_COROUTINES requires the <coroutine> header"
+#endif
+#define FG_EVENT_COROUTINES 1
+#endif
 
 namespace event
 {
     using CallbacksVec = std::vector<::util::Callback *>;
-    using CallbacksBindingMap = std::map<Type, CallbacksVec>;
+    /// Immutable snapshot of callbacks bound to a single event type. Writers publish
+    /// a new version (copy on write), dispatchers only take a reference to the current one.
+    using CallbacksList = std::shared_ptr<const CallbacksVec>;
+    using CallbacksBindingMap = DispatchTable<CallbacksList>;
+
+    /// Callback removed from the binds, deleted once the dispatches of its epoch finish
+    struct RetiredCallback
+    {
+        ::util::Callback *pCallback;
+        uint64_t epoch;
+    }; //# struct RetiredCallback
+
+    /**
+     * Pre-dispatch filter attached to the callback at registration. Filtered callbacks
+     * are indexed by the key and called only for events carrying the same key, instead
+     * of every callback bound to the event type checking the event by itself. The key
+     * meaning depends on the event type (see getEventFilterKey).
+     */
+    struct EventFilter
+    {
+        uint32_t key;
+
+        static inline EventFilter keyCode(KeyCode code) { return EventFilter{static_cast<uint32_t>(code)}; }
+        /// Mouse button or touch identifier
+        static inline EventFilter button(unsigned int buttonID) { return EventFilter{buttonID}; }
+        static inline EventFilter controllerButton(unsigned short button) { return EventFilter{button}; }
+        /// Resource type (resource::ResourceType)
+        static inline EventFilter resourceType(unsigned int type) { return EventFilter{type}; }
+    }; //# struct EventFilter
+
+    /// Filter key -> callbacks, immutable snapshot per event type (copy on write)
+    using FilteredCallbacks = std::unordered_map<uint32_t, CallbacksVec>;
+    using FilteredCallbacksList = std::shared_ptr<const FilteredCallbacks>;
+    using FilteredBindingMap = DispatchTable<FilteredCallbacksList>;
+
+    /**
+     * @return True if events of the given type can be filtered
+     */
+    inline bool isFilterableEventType(Type eventCode) noexcept
+    {
+        switch (eventCode)
+        {
+        case Type::KeyDown:
+        case Type::KeyUp:
+        case Type::KeyPressed:
+        case Type::TouchPressed:
+        case Type::TouchReleased:
+        case Type::TouchMotion:
+        case Type::MousePressed:
+        case Type::MouseReleased:
+        case Type::MouseMotion:
+        case Type::GameControllerButton:
+        case Type::ResourceCreated:
+        case Type::ResourceRemoved:
+        case Type::ResourceDisposed:
+        case Type::ResourceDestroyed:
+        case Type::ResourceRequested:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * Extract the filter key from the event structure: key code for keyboard events,
+     * button for mouse/touch and controller events, resource type for resource events.
+     * @return False if events of this type can't be filtered
+     */
+    inline bool getEventFilterKey(Type eventCode, const EventCombined &event, uint32_t &key) noexcept
+    {
+        switch (eventCode)
+        {
+        case Type::KeyDown:
+        case Type::KeyUp:
+        case Type::KeyPressed:
+            key = static_cast<uint32_t>(event.key.keyCode);
+            return true;
+        case Type::TouchPressed:
+        case Type::TouchReleased:
+        case Type::TouchMotion:
+            key = event.touch.buttonID;
+            return true;
+        case Type::MousePressed:
+        case Type::MouseReleased:
+        case Type::MouseMotion:
+            key = event.mouse.buttonID;
+            return true;
+        case Type::GameControllerButton:
+            key = event.controllerButton.button;
+            return true;
+        case Type::ResourceCreated:
+        case Type::ResourceRemoved:
+        case Type::ResourceDisposed:
+        case Type::ResourceDestroyed:
+        case Type::ResourceRequested:
+            key = event.resource.resourceType;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * Modifier groups used by key bindings - left and right variants of the same
+     * modifier are not distinguished, lock keys (NUM, CAPS, MODE) are ignored.
+     */
+    enum class KeyModGroup : uint8_t
+    {
+        None = 0x00,
+        Shift = 0x01,
+        Ctrl = 0x02,
+        Alt = 0x04,
+        Gui = 0x08
+    };
+
+    /**
+     * Reduce the modifier state to the mask of modifier groups (see KeyModGroup)
+     */
+    inline uint8_t getKeyModMask(KeyMod mod) noexcept
+    {
+        const auto bits = static_cast<unsigned int>(mod);
+        uint8_t mask = 0;
+        if (bits & (static_cast<unsigned int>(KeyMod::LSHIFT) | static_cast<unsigned int>(KeyMod::RSHIFT)))
+            mask |= static_cast<uint8_t>(KeyModGroup::Shift);
+        if (bits & (static_cast<unsigned int>(KeyMod::LCTRL) | static_cast<unsigned int>(KeyMod::RCTRL)))
+            mask |= static_cast<uint8_t>(KeyModGroup::Ctrl);
+        if (bits & (static_cast<unsigned int>(KeyMod::LALT) | static_cast<unsigned int>(KeyMod::RALT)))
+            mask |= static_cast<uint8_t>(KeyModGroup::Alt);
+        if (bits & (static_cast<unsigned int>(KeyMod::LGUI) | static_cast<unsigned int>(KeyMod::RGUI)))
+            mask |= static_cast<uint8_t>(KeyModGroup::Gui);
+        return mask;
+    }
 
-    using KeyBindingMap = std::map<KeyCode, CallbacksVec>;
-    using EventsQueue = Queue<event::ThrownEvent>;
+    /**
+     * Callback bound to the key combination - the modifier mask has to match exactly
+     * (Ctrl+S does not trigger on Ctrl+Shift+S)
+     */
+    struct KeyBinding
+    {
+        ::util::Callback *callback;
+        uint8_t modMask;
+    }; //# struct KeyBinding
+
+    using KeyBindingsVec = std::vector<KeyBinding>;
+    /// Immutable snapshot of the bindings for a single key (copy on write)
+    using KeyBindingsList = std::shared_ptr<const KeyBindingsVec>;
+    /// Number of key codes covered by the key binding table
+    inline constexpr std::size_t NUM_KEY_BINDING_CODES = static_cast<std::size_t>(KeyCode::NUM_VIRTUAL_KEYS);
+    /// Key bindings indexed directly with the key code
+    using KeyBindingMap = std::array<KeyBindingsList, NUM_KEY_BINDING_CODES>;
+    using EventsQueue = util::MpscQueue<event::ThrownEvent>;
 
-    using TimerEntries = Queue<event::TimerEntryInfo>;
     using EventsPtrVec = std::vector<EventCombined *>;
+    using EventStructPool = util::SlabPool<EventCombined>;
+
+    /**
+     * How events of the same type thrown before the next processEvents() are merged
+     */
+    enum class CoalescePolicy : unsigned int
+    {
+        /// Every thrown event is dispatched
+        None = 0,
+        /// Only the latest event is dispatched (previous ones are dropped)
+        KeepLatest = 1,
+        /// Latest state, relative values are summed up (mouse/touch motion) - for other
+        /// event types this works the same way as KeepLatest
+        AccumulateDeltas = 2
+    };
+
+    /**
+     * @brief Pending (merged) events for a single event type. Only a marker goes through
+     * the events queue - the marker keeps the position of the first merged event.
+     * Events are merged into the latest pending one only, an incompatible event (other
+     * finger, device or axis) starts a new pending event with its own marker, so the
+     * throw order is kept. Markers take the pending events in order.
+     */
+    struct CoalesceSlot
+    {
+        std::atomic<CoalescePolicy> policy;
+        /// Number of events merged into pending ones (metrics)
+        std::atomic<uint64_t> mergedCount;
+        std::mutex mutex;
+        std::deque<ThrownEvent> pending;
+
+        CoalesceSlot(CoalescePolicy _policy) : policy(_policy), mergedCount(0), mutex(), pending() {}
+    }; //# struct CoalesceSlot
+
+    using CoalesceSlots = DispatchTable<std::shared_ptr<CoalesceSlot>>;
+
+    /**
+     * Priority lane of the event type - lanes are processed in order (High first)
+     */
+    enum class EventLane : unsigned int
+    {
+        /// Input and other latency sensitive events
+        High = 0,
+        /// Default lane for all event types
+        Normal = 1,
+        /// Notifications that can wait (resources, loading)
+        Low = 2
+    };
+
+    inline constexpr unsigned int NUM_EVENT_LANES = 3;
+
+    struct EventLaneStats
+    {
+        /// Number of events waiting in the lane after the last processEvents()
+        std::size_t depth;
+        /// Total number of events dispatched from this lane
+        uint64_t dispatched;
+        /// Total number of events carried over to the next frame (counted per frame)
+        uint64_t carriedOver;
+
+        EventLaneStats() : depth(0), dispatched(0), carriedOver(0) {}
+    }; //# struct EventLaneStats
+
+    /**
+     * What happens to an event thrown into a lane that is full (see setLaneCapacity)
+     */
+    enum class OverflowPolicy : uint8_t
+    {
+        /// The incoming event is dropped
+        DropNewest,
+        /// The oldest event that was not collected yet is dropped
+        DropOldest,
+        /// The incoming event replaces the newest pending event of the same type
+        /// (dropped if there is none)
+        Coalesce,
+        /// The producer waits for the consumer (up to the timeout, then drops). On the
+        /// processing thread this works as DropNewest - the wait could not end early
+        Block
+    };
+
+    /**
+     * Overflow counters of a lane with limited capacity (snapshot)
+     */
+    struct EventOverflowStats
+    {
+        std::size_t capacity;
+        /// Events waiting for dispatch (not collected + carried over)
+        std::size_t queued;
+        uint64_t dropped;
+        uint64_t coalesced;
+        /// Number of times a producer had to wait for space
+        uint64_t blocked;
+
+        EventOverflowStats() : capacity(0), queued(0), dropped(0), coalesced(0), blocked(0) {}
+    }; //# struct EventOverflowStats
+
+    /**
+     * @brief Bounded intake of a priority lane. Events of a limited lane don't go through
+     * the events queue - producers append them here under the lock, so the overflow
+     * policy can be applied at throw time.
+     */
+    struct LaneLimit
+    {
+        std::mutex mutex;
+        std::condition_variable spaceCondition;
+        /// Thrown events that were not collected yet
+        std::deque<ThrownEvent> buffered;
+        /// Number of events left in the lane after the last processEvents (carried over)
+        std::size_t carried;
+        std::size_t capacity;
+        OverflowPolicy policy;
+        int blockTimeoutMs;
+        std::atomic_bool active;
+        std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> coalesced;
+        std::atomic<uint64_t> blocked;
+
+        LaneLimit() : mutex(), spaceCondition(), buffered(), carried(0), capacity(0),
+                      policy(OverflowPolicy::DropOldest), blockTimeoutMs(0), active(false),
+                      dropped(0), coalesced(0), blocked(0) {}
+
+        /// Lock must be held
+        inline bool isFull(void) const noexcept { return buffered.size() + carried >= capacity; }
+    }; //# struct LaneLimit
+
+    struct EventTypeOptions
+    {
+        EventLane lane;
+        /// All handlers of this type can be executed concurrently
+        bool parallel;
+
+        EventTypeOptions() : lane(EventLane::Normal), parallel(false) {}
+    }; //# struct EventTypeOptions
+
+    /// Options per event type indexed with the event code (copy on write snapshot)
+    using EventTypeOptionsVec = std::vector<EventTypeOptions>;
+    using EventTypeOptionsList = std::shared_ptr<const EventTypeOptionsVec>;
+    /// Events moved out of the queue, waiting for dispatch (consumer side only)
+    using PendingEvents = std::deque<ThrownEvent>;
+
+#if defined(FG_EVENT_COROUTINES)
+    /**
+     * @brief Intrusive node of a suspended coroutine waiting for the next event of a type
+     * or for a deadline (see EventAwait.hpp). The node lives in the coroutine frame, so
+     * waiting does not allocate. The manager only calls the hooks.
+     */
+    struct EventWaiter
+    {
+        EventWaiter *next;
+        /// Resume the coroutine on the processing thread - the event structure is valid
+        /// until the coroutine suspends again (null for deadlines and events without it)
+        void (*resume)(EventWaiter *self, EventCombined *pEvent);
+        /// Destroy the suspended coroutine (manager destroyed while waiting)
+        void (*cancel)(EventWaiter *self);
+        /// Deadline in milliseconds (timesys::ticks) for sleeping waiters
+        int64_t deadline;
+    }; //# struct EventWaiter
+
+    /// Waiters per event type - intrusive list, newest first
+    using EventWaitersTable = DispatchTable<EventWaiter *>;
+#endif //> FG_EVENT_COROUTINES
+
+    /**
+     * @brief Events thrown by a single producer thread, spliced into the lanes once per
+     * frame (see EventManager::setThreadStaging). The mutex is taken by the owner on
+     * every throw and by the consumer only while splicing, so between frames the cache
+     * lines stay with the producer core. Buffers that stay empty are retired by the
+     * consumer - the producer holds a reference, so the memory outlives the removal and
+     * the producer switches to a new buffer on the next throw.
+     */
+    struct alignas(64) StagingBuffer
+    {
+        std::mutex mutex;
+        std::vector<ThrownEvent> events;
+        std::thread::id owner;
+        /// Removed from the manager - producers must acquire another buffer (guarded by mutex)
+        bool retired;
+        /// Number of consecutive splices without events (consumer only)
+        unsigned int idleFrames;
+
+        explicit StagingBuffer(std::thread::id _owner) : mutex(), events(), owner(_owner), retired(false), idleFrames(0) {}
+    }; //# struct StagingBuffer
+
+    /**
+     * @brief Counters and latency histograms for a single event type (nanoseconds).
+     * Updated lock-free from the throwing threads and the dispatching thread.
+     */
+    struct EventTypeMetrics
+    {
+        /// Number of thrown events (including the ones merged by coalescing)
+        std::atomic<uint64_t> thrown;
+        /// Number of dispatched events (executeEvent calls)
+        std::atomic<uint64_t> dispatched;
+        /// Number of executed callbacks
+        std::atomic<uint64_t> callbacks;
+        /// Time between throwEvent and the start of dispatch
+        util::Histogram queueWait;
+        /// Time of the whole dispatch (all callbacks, including the join)
+        util::Histogram dispatchTime;
+        /// Time of a single callback executed on the dispatching thread
+        util::Histogram callbackTime;
+        /// The slowest callback seen so far - for identification only, may be deleted
+        std::atomic<const util::Callback *> slowestCallback;
+        std::atomic<uint64_t> slowestCallbackTime;
+
+        EventTypeMetrics() : thrown(0), dispatched(0), callbacks(0),
+                             queueWait(), dispatchTime(), callbackTime(),
+                             slowestCallback(nullptr), slowestCallbackTime(0) {}
+
+        void reset(void)
+        {
+            thrown.store(0);
+            dispatched.store(0);
+            callbacks.store(0);
+            queueWait.reset();
+            dispatchTime.reset();
+            callbackTime.reset();
+            slowestCallback.store(nullptr);
+            slowestCallbackTime.store(0);
+        }
+    }; //# struct EventTypeMetrics
+
+    using EventMetricsTable = DispatchTable<std::shared_ptr<EventTypeMetrics>>;
 
 } //> namespace event
 
@@ -2,15 +2,66 @@
 #include <util/Timesys.hpp>
 #include <util/Util.hpp>
 
+#include <magic_enum.hpp>
+
+#include <algorithm>
+#include <chrono>
+
 event::EventManager::EventManager() : base_type(),
                                       m_eventBinds(),
-                                      m_eventsQueue(),
-                                      m_timerEntries(),
-                                      m_cleanupIntervalId(),
+                                      m_filteredBinds(),
+                                      m_hasFilters(false),
+                                      m_keyDownBindings(),
+                                      m_keyUpBindings(),
+                                      m_hasKeyBindings(false),
+                                      m_eventsQueue(MAX_THROWN_EVENTS),
+                                      m_coalesceSlots(),
+                                      m_hasCoalescing(false),
+                                      m_typeOptions(),
+#if defined(FG_EVENT_COROUTINES)
+                                      m_eventWaiters(),
+                                      m_eventWaitersCount(0),
+                                      m_sleepWaiters(),
+                                      m_hasSleepWaiters(false),
+#endif
+                                      m_stagingBuffers(),
+                                      m_splicedEvents(),
+                                      m_mutexStaging(),
+                                      m_threadStaging(false),
+                                      m_hasStagingBuffers(false),
+                                      m_stagingId(++s_stagingIds),
+                                      m_processingThread(),
+                                      m_laneLimits(),
+                                      m_hasLaneLimits(false),
+                                      m_lanes(),
+                                      m_laneStats(),
+                                      m_budgetEvents(0),
+                                      m_budgetTime(0.0),
+                                      m_workerPool(),
+                                      m_pRecorder(nullptr),
+                                      m_metrics(),
+                                      m_metricsEnabled(false),
+                                      m_eventTypes(),
+                                      m_timers(),
+                                      m_dueTimers(),
+                                      m_handoffTimers(),
+                                      m_timerThread(),
+                                      m_timerThreadRunning(false),
+                                      m_timerThreadMode(TimerThreadMode::Fire),
+                                      m_timerNotify(),
+                                      m_timerThreadStop(false),
+                                      m_timerThreadWake(false),
+                                      m_mutexTimerThread(),
+                                      m_timerThreadCondition(),
                                       m_markedTimeouts(),
                                       m_eventStructs(),
-                                      m_eventStructsFreeSlots()
+                                      m_retiredCallbacks(),
+                                      m_dispatchEpoch(0),
+                                      m_activeDispatches(),
+                                      m_hasRetiredCallbacks(false)
 {
+    for (auto &active : m_activeDispatches)
+        active.store(0, std::memory_order_relaxed);
     m_thread.setThreadName("EventManager");
 }
 //>---------------------------------------------------------------------------------------
@@ -21,453 +72,1294 @@ event::EventManager::~EventManager()
 }
 //>---------------------------------------------------------------------------------------
 
-void event::EventManager::pushToFreeSlot(EventBase *ptr)
+void event::EventManager::releaseArgument(util::WrappedValue *pValue)
 {
-    if (!ptr)
-        return;
-    m_eventStructsFreeSlots.push_back(reinterpret_cast<event::EventCombined *>(ptr));
+    if (pValue && pValue->isExternal() && pValue->getExternalPointer<void>() != nullptr)
+    {
+        // O(1) ownership check, double release is ignored
+        auto pStruct = reinterpret_cast<event::EventCombined *>(pValue->getExternalPointer<void>());
+        m_eventStructs.destroy(pStruct);
+    }
 }
 //>---------------------------------------------------------------------------------------
 
 void event::EventManager::resetArguments(WrappedArgs &args)
 {
     for (auto &arg : args)
-    {
-        if (arg->isExternal() && arg->getExternalPointer<void>() != nullptr)
-        {
-            auto pStruct = reinterpret_cast<event::EventCombined *>(arg->getExternalPointer<void>());
-            if (util::find(m_eventStructs, pStruct) >= 0)
-                pushToFreeSlot((EventBase *)pStruct);
-        }
-    }
+        releaseArgument(arg);
     util::reset_arguments(args);
 }
 //>---------------------------------------------------------------------------------------
 
+void event::EventManager::resetArguments(EventArgs &args)
+{
+    for (size_t idx = 0; idx < args.size(); idx++)
+        releaseArgument(args[idx]);
+    args.reset();
+}
+//>---------------------------------------------------------------------------------------
+
 bool event::EventManager::destroy(void)
 {
-    /* mutex events queue */ {
-        const std::lock_guard<std::mutex> lock(m_mutexEventsQueue);
-        while (!m_eventsQueue.empty())
+    stopTimerThread();
+    m_workerPool.stop();
+#if defined(FG_EVENT_COROUTINES)
+    cancelWaiters();
+#endif
+    m_eventsQueue.drain([this](ThrownEvent &&thrownEvent)
+                        { resetArguments(thrownEvent.args); });
+    for (auto &pending : m_lanes)
+    {
+        for (auto &thrownEvent : pending)
+            resetArguments(thrownEvent.args);
+        pending.clear();
+    }
+    m_hasLaneLimits.store(false);
+    for (auto &limit : m_laneLimits)
+    {
+        /* lock mutex lane limit */ {
+            const std::lock_guard<std::mutex> lock(limit.mutex);
+            limit.active.store(false);
+            limit.capacity = 0;
+            limit.carried = 0;
+            for (auto &thrownEvent : limit.buffered)
+                resetArguments(thrownEvent.args);
+            limit.buffered.clear();
+        }
+        limit.spaceCondition.notify_all();
+    }
+    /* lock mutex staging */ {
+        const std::lock_guard<std::mutex> lock(m_mutexStaging);
+        for (auto &pBuffer : m_stagingBuffers)
         {
-            resetArguments(m_eventsQueue.front().args);
-            m_eventsQueue.pop();
+            for (auto &thrownEvent : pBuffer->events)
+                resetArguments(thrownEvent.args);
         }
-        m_eventsQueue.clear();
+        m_stagingBuffers.clear();
+        m_splicedEvents.clear();
+        m_threadStaging.store(false);
+        m_hasStagingBuffers.store(false);
+        m_stagingId.store(++s_stagingIds); // invalidate cached buffers of all threads
+    }
+    /* mutex event binds */ {
+        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+        m_coalesceSlots.forEach([this](Type eventCode, std::shared_ptr<CoalesceSlot> &slot)
+                                {
+            if (!slot)
+                return false;
+            for (auto &thrownEvent : slot->pending)
+                resetArguments(thrownEvent.args);
+            slot->pending.clear();
+            return false; });
+        m_coalesceSlots.clear();
+        m_hasCoalescing.store(false);
+        m_metrics.clear();
     }
     std::vector<event::Type> boundEvents;
     /* mutex event binds */ {
         const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-        m_eventStructsFreeSlots.clear();
-        while (m_eventStructs.size())
-        {
-            EventCombined *ptr = m_eventStructs.back();
-            delete ptr;
-            m_eventStructs.pop_back();
-        } //# for each event structure
-
-        for (auto &it : m_eventBinds)
-            boundEvents.push_back(it.first);
+        m_eventBinds.forEach([&boundEvents](Type eventCode, CallbacksList &slot)
+                             {
+            boundEvents.push_back(eventCode);
+            return false; });
+        m_filteredBinds.forEach([&boundEvents](Type eventCode, FilteredCallbacksList &slot)
+                                {
+            boundEvents.push_back(eventCode); // deleting twice is harmless
+            return false; });
     }
     for (auto eventType : boundEvents)
         this->deleteCallbacks(eventType);
-    m_eventBinds.clear();
-    m_eventStructs.clear();
+    deleteKeyBindings();
+    /* mutex event binds */ {
+        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+        m_eventBinds.clear();
+        m_filteredBinds.clear();
+        m_hasFilters.store(false);
+    }
+    reclaimCallbacks();
     /* mutex timers */ {
         const std::lock_guard<std::mutex> lock(m_mutexTimers);
-        for (auto &timer : m_timerEntries)
-        {
+        m_timers.forEach([this](TimerEntryInfo &timer)
+                         {
             resetArguments(timer.args); // cleanup arguments (just in case)
-            timer.deactivate();         // mark for removal
-        }
+            timer.deactivate(); /* mark for removal */ });
     }
     removeInactiveTimers();
     /* mutex timers */ {
         const std::lock_guard<std::mutex> lock(m_mutexTimers);
-        m_timerEntries.clear();
+        m_timers.clear();
     }
     m_init.store(false); // mark as deinitialized
-    m_cleanupIntervalId = 0;
     return true;
 }
 //>---------------------------------------------------------------------------------------
 
 bool event::EventManager::initialize(void)
 {
-    m_eventStructs.reserve(INITIAL_PTR_VEC_SIZE);
+    m_eventStructs.reserve(MAX_EVENT_STRUCTS);
     m_init.store(true);
-    m_cleanupIntervalId = addInterval(60 * 1000, this, &EventManager::removeInactiveTimers);
     return true;
 }
 //>---------------------------------------------------------------------------------------
 
 event::EventBase *event::EventManager::requestEventStruct(Type eventType)
 {
-    EventCombined *pEventStruct = nullptr;
-    if (m_eventStructsFreeSlots.empty())
-    {
-        pEventStruct = new event::EventCombined(eventType);
-        m_eventStructs.push_back(pEventStruct);
-    }
-    else
+    // no lock - the pool is thread safe (thread-local free lists)
+    return reinterpret_cast<EventBase *>(m_eventStructs.create(eventType));
+}
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::releaseEventStruct(EventBase *pEventStruct)
+{
+    return m_eventStructs.destroy(reinterpret_cast<EventCombined *>(pEventStruct));
+}
+//>---------------------------------------------------------------------------------------
+
+std::size_t event::EventManager::requestEventStructs(Type eventType, std::size_t count, EventsPtrVec &output)
+{
+    output.reserve(output.size() + count);
+    for (std::size_t idx = 0; idx < count; idx++)
     {
-        pEventStruct = m_eventStructsFreeSlots.back();
-        pEventStruct->setup(eventType);
-        m_eventStructsFreeSlots.pop_back();
+        auto pStruct = m_eventStructs.create(eventType);
+        if (!pStruct)
+            return idx;
+        output.push_back(pStruct);
     }
-    return reinterpret_cast<EventBase *>(pEventStruct);
+    return count;
 }
 //>---------------------------------------------------------------------------------------
 
-event::ThrownEvent &event::EventManager::throwEvent(Type eventCode, WrappedArgs &args)
+bool event::EventManager::throwEvent(Type eventCode, WrappedArgs &args)
 {
-    const std::lock_guard<std::mutex> lock(m_mutexEventsQueue);
-    m_eventsQueue.emplace(ThrownEvent(eventCode, args));
-    return m_eventsQueue.back();
+    // no lock - the queue is multi-producer safe, ownership of args is moved
+    return throwEvent(ThrownEvent(eventCode, args));
 }
 //>---------------------------------------------------------------------------------------
 
-bool event::EventManager::isRegisteredCallback(Type eventCode, util::Callback *pCallback)
+void event::EventManager::noteThrownEvent(ThrownEvent &thrownEvent)
 {
-    if (eventCode == event::Type::Invalid || !pCallback)
-        return false;
-    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-    auto found = m_eventBinds.find(eventCode);
-    if (found == m_eventBinds.end())
-        return false;
-    return util::find(found->second, pCallback) >= 0;
-} //> isRegistered(...)
+    if (m_metricsEnabled.load(std::memory_order_relaxed))
+    {
+        acquireMetrics(thrownEvent.eventCode)->thrown.fetch_add(1, std::memory_order_relaxed);
+        thrownEvent.queuedNs = metricsClock();
+    }
+    auto pRecorder = m_pRecorder.load(std::memory_order_acquire);
+    if (pRecorder)
+        pRecorder->recordEvent(thrownEvent, m_eventStructs); //! Lock - recorder
+} //> noteThrownEvent(...)
 //>---------------------------------------------------------------------------------------
 
-event::Type event::EventManager::isRegisteredCallback(util::Callback *pCallback)
+bool event::EventManager::throwEvent(ThrownEvent &&thrownEvent)
 {
-    if (!pCallback)
-        return event::Type::Invalid;
-    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-    Type foundEvent = event::Type::Invalid;
-    for (auto &it : m_eventBinds)
+    if (m_hasCoalescing.load(std::memory_order_acquire))
     {
-        if (util::find(it.second, pCallback) >= 0)
+        auto pSlot = loadCoalesceSlot(thrownEvent.eventCode);
+        const auto policy = pSlot ? pSlot->policy.load() : CoalescePolicy::None;
+        if (policy != CoalescePolicy::None)
         {
-            foundEvent = it.first;
-            break;
+            // coalesced events are always admitted (markers are not limited by the capacity)
+            noteThrownEvent(thrownEvent); //! Lock - recorder
+            const auto eventCode = thrownEvent.eventCode;
+            /* lock mutex coalesce slot */ {
+                const std::lock_guard<std::mutex> lock(pSlot->mutex);
+                if (!pSlot->pending.empty() && mergeEvents(pSlot->pending.back(), thrownEvent, policy))
+                {
+                    pSlot->mergedCount++;
+                    return true; // marker is already in the queue
+                }
+                // first or not compatible with the latest one - new pending event, merging
+                // into the earlier ones would reorder the events
+                pSlot->pending.push_back(std::move(thrownEvent));
+            }
+            ThrownEvent marker(eventCode);
+            marker.coalesced = true;
+            queueMarker(std::move(marker)); //! Lock - lane limit
+            return true;
         }
-    } //# for each bound event type
-    return foundEvent;
-} //> isRegistered(...)
+    }
+    if (m_hasLaneLimits.load(std::memory_order_acquire))
+    {
+        auto pLimit = findLaneLimit(thrownEvent.eventCode);
+        if (pLimit)
+            return pushLimited(*pLimit, std::move(thrownEvent)); //! Lock - lane limit
+    }
+    noteThrownEvent(thrownEvent); //! Lock - recorder
+    if (isThreadStaging())
+        stageEvents(&thrownEvent, 1);
+    else
+        m_eventsQueue.push(std::move(thrownEvent)); // ring or overflow path - queued either way
+    return true;
+} //> throwEvent(...)
 //>---------------------------------------------------------------------------------------
 
-unsigned int event::EventManager::executeEvent(Type eventCode)
+bool event::EventManager::throwEvents(ThrownEvent *events, std::size_t count)
 {
-    CallbacksVec callbacks;
-    unsigned int count = 0;
+    if (!events || !count)
+        return true;
+    if (hasCoalescing(events, count) || m_hasLaneLimits.load(std::memory_order_acquire))
     {
-        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-        auto found = m_eventBinds.find(eventCode);
-        if (found == m_eventBinds.end())
-            return 0;
-        callbacks = (*found).second; // copy vec
+        // merging and limits are applied per event, the block can't be reserved up front
+        bool status = true;
+        for (std::size_t idx = 0; idx < count; idx++)
+            status = throwEvent(std::move(events[idx])) && status;
+        return status;
     }
-    for (auto callback : callbacks)
+    if (m_metricsEnabled.load(std::memory_order_relaxed))
     {
-        if (!callback)
-            continue;
-        (*callback)();
-        count++;
-    } //> for each callback
-    return count;
-} //> executeEvent(...)
+        const auto queuedNs = metricsClock();
+        for (std::size_t idx = 0; idx < count; idx++)
+        {
+            acquireMetrics(events[idx].eventCode)->thrown.fetch_add(1, std::memory_order_relaxed);
+            events[idx].queuedNs = queuedNs;
+        }
+    }
+    auto pRecorder = m_pRecorder.load(std::memory_order_acquire);
+    for (std::size_t idx = 0; pRecorder && idx < count; idx++)
+        pRecorder->recordEvent(events[idx], m_eventStructs); //! Lock - recorder
+    if (isThreadStaging())
+        stageEvents(events, count);
+    else
+        m_eventsQueue.pushBatch(events, count);
+    return true;
+} //> throwEvents(...)
 //>---------------------------------------------------------------------------------------
 
-unsigned int event::EventManager::executeEvent(ThrownEvent &thrownEvent)
+void event::EventManager::discardEvents(ThrownEvent *events, std::size_t count)
 {
-    CallbacksVec callbacks;
-    unsigned int count = 0;
+    if (!events)
+        return;
+    for (std::size_t idx = 0; idx < count; idx++)
+        resetArguments(events[idx].args);
+} //> discardEvents(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::hasCoalescing(ThrownEvent *events, std::size_t count) const
+{
+    if (!m_hasCoalescing.load(std::memory_order_acquire))
+        return false;
+    for (std::size_t idx = 0; idx < count; idx++)
     {
-        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-        auto found = m_eventBinds.find(thrownEvent.eventCode);
-        if (found == m_eventBinds.end())
-        {
-            resetArguments(thrownEvent.args);
-            return 0;
-        }
-        callbacks = (*found).second;
+        if (getCoalescePolicy(events[idx].eventCode) != CoalescePolicy::None)
+            return true;
     }
-    for (auto callback : callbacks)
-    {
-        if (!callback)
-            continue;
-        if (thrownEvent.args.size())
-            (*callback)(thrownEvent.args);
-        else
-            (*callback)();
-        count++;
-    } //> for each callback
-    //
-    // Thrown event arguments need to be reset/removed after all events are processed.
-    // If there is an event structure on the argument's list, it will be retrieved and
-    // added back to the free list;
-    resetArguments(thrownEvent.args);
-    return count;
-} //> executeEvent(...)
+    return false;
+} //> hasCoalescing(...)
 //>---------------------------------------------------------------------------------------
 
-unsigned int event::EventManager::executeEvent(Type eventCode, WrappedArgs &args)
+void event::EventManager::setCoalescePolicy(Type eventCode, CoalescePolicy policy)
 {
-    CallbacksVec callbacks;
-    unsigned int count = 0;
+    if (eventCode == Type::Invalid)
+        return;
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    auto &slot = m_coalesceSlots[eventCode];
+    if (!slot)
     {
-        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-        auto found = m_eventBinds.find(eventCode);
-        if (found == m_eventBinds.end())
-        {
-            resetArguments(args);
-            return 0;
-        }
-        callbacks = (*found).second; // create a copy for calling functions
+        if (policy == CoalescePolicy::None)
+            return;
+        std::atomic_store(&slot, std::make_shared<CoalesceSlot>(policy));
     }
-    for (auto callback : callbacks)
+    else
     {
-        if (!callback)
-            continue;
-        if (args.size())
-            (*callback)(args);
-        else
-            (*callback)();
-        count++;
-    } //> for each callback
-    resetArguments(args);
-    return count;
-} //> executeEvent(...)
+        // the slot is never removed - markers already in the queue still refer to it
+        slot->policy.store(policy);
+    }
+    if (policy != CoalescePolicy::None)
+        m_hasCoalescing.store(true, std::memory_order_release);
+} //> setCoalescePolicy(...)
 //>---------------------------------------------------------------------------------------
 
-util::Callback *event::EventManager::addCallback(util::Callback *pCallback, Type eventCode)
+event::CoalescePolicy event::EventManager::getCoalescePolicy(Type eventCode) const
 {
-    if (!pCallback || (int)eventCode < 0)
-        return nullptr;
-    // Duplicate callbacks are not allowed for the same event (avoid double trigger)
-    if (isRegisteredCallback(eventCode, pCallback)) //! Lock - event binds
-        return nullptr;
+    auto pSlot = loadCoalesceSlot(eventCode);
+    return pSlot ? pSlot->policy.load() : CoalescePolicy::None;
+} //> getCoalescePolicy(...)
+//>---------------------------------------------------------------------------------------
+
+uint64_t event::EventManager::getCoalescedCount(Type eventCode) const
+{
+    auto pSlot = loadCoalesceSlot(eventCode);
+    return pSlot ? pSlot->mergedCount.load() : 0;
+} //> getCoalescedCount(...)
+//>---------------------------------------------------------------------------------------
+
+std::shared_ptr<event::CoalesceSlot> event::EventManager::loadCoalesceSlot(Type eventCode) const
+{
+    if (!CoalesceSlots::isDense(eventCode))
     {
         const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-        m_eventBinds[eventCode].push_back(pCallback);
+        auto pSlot = m_coalesceSlots.find(eventCode);
+        return pSlot ? std::atomic_load(pSlot) : std::shared_ptr<CoalesceSlot>();
     }
-    return pCallback;
-} //> addCallback(...)
+    auto pSlot = m_coalesceSlots.find(eventCode);
+    if (!pSlot)
+        return std::shared_ptr<CoalesceSlot>();
+    return std::atomic_load(pSlot);
+} //> loadCoalesceSlot(...)
 //>---------------------------------------------------------------------------------------
 
-bool event::EventManager::removeCallback(Type eventCode, util::Callback *pCallback)
+bool event::EventManager::mergeEvents(ThrownEvent &pending, ThrownEvent &incoming, CoalescePolicy policy)
 {
-    if (!pCallback || (int)eventCode < 0)
+    // The event structure (if any) is always the first argument
+    auto getStruct = [this](EventArgs &args) -> EventCombined *
+    {
+        if (args.empty() || !args[0]->isExternal())
+            return nullptr;
+        auto pStruct = reinterpret_cast<EventCombined *>(args[0]->getExternalPointer<void>());
+        return m_eventStructs.owns(pStruct) ? pStruct : nullptr;
+    };
+    if (pending.args.size() != incoming.args.size())
         return false;
-    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-    auto &callbacksVec = m_eventBinds[eventCode];
-    if (callbacksVec.empty())
+    auto pOld = getStruct(pending.args);
+    auto pNew = getStruct(incoming.args);
+    if ((pOld == nullptr) != (pNew == nullptr))
         return false;
-    auto cit = callbacksVec.begin(), end = callbacksVec.end();
-    for (; cit != end; cit++)
+    if (pOld && pNew)
     {
-        if (*cit == pCallback)
+        switch (pending.eventCode)
         {
-            m_eventBinds[eventCode].erase(cit);
-            return true;
+        case Type::TouchPressed:
+        case Type::TouchReleased:
+        case Type::TouchMotion:
+        case Type::MousePressed:
+        case Type::MouseReleased:
+        case Type::MouseMotion:
+            // touch and mouse structures share the layout
+            if (pOld->touch.pointerID != pNew->touch.pointerID || pOld->touch.pressed != pNew->touch.pressed)
+                return false;
+            if (policy == CoalescePolicy::AccumulateDeltas)
+            {
+                pNew->touch.relX += pOld->touch.relX;
+                pNew->touch.relY += pOld->touch.relY;
+            }
+            break;
+        case Type::GameControllerAxis:
+            if (pOld->controllerAxis.which != pNew->controllerAxis.which || pOld->controllerAxis.axis != pNew->controllerAxis.axis)
+                return false;
+            break;
+        case Type::SensorsChanged:
+            if (pOld->sensors.sensorType != pNew->sensors.sensorType)
+                return false;
+            break;
+        default:
             break;
         }
-    } //> for each callback
+    }
+    // latest one wins - previous structure goes back to the pool
+    resetArguments(pending.args);
+    pending.args = std::move(incoming.args);
     return true;
-} //> removeCallback(...)
+} //> mergeEvents(...)
 //>---------------------------------------------------------------------------------------
 
-event::CallbacksVec event::EventManager::removeCallbacks(Type eventCode)
+event::EventTypeOptions event::EventManager::getTypeOptions(Type eventCode) const
 {
-    if ((int)eventCode < 0)
-        return event::CallbacksVec();
-    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-    auto &callbacksVec = m_eventBinds[eventCode];
-    if (callbacksVec.empty())
-        return event::CallbacksVec();
-    event::CallbacksVec output;
-    auto cit = callbacksVec.begin(), end = callbacksVec.end();
-    for (; cit != end; cit++)
-    {
-        output.push_back(*cit);
-        *cit = nullptr;
-    }
-    callbacksVec.clear();
-    return output;
-} //> removeCallbacks(...)
+    const auto code = static_cast<std::size_t>(eventCode);
+    auto pOptions = std::atomic_load(&m_typeOptions);
+    if (!pOptions || code >= pOptions->size())
+        return EventTypeOptions();
+    return (*pOptions)[code];
+} //> getTypeOptions(...)
 //>---------------------------------------------------------------------------------------
 
-bool event::EventManager::deleteCallback(Type eventCode, util::Callback *&pCallback)
+void event::EventManager::publishTypeOptions(Type eventCode, const EventTypeOptions &options)
 {
-    if (!pCallback || (int)eventCode < 0)
+    const auto code = static_cast<std::size_t>(eventCode);
+    auto pCurrent = std::atomic_load(&m_typeOptions);
+    EventTypeOptionsVec updated;
+    if (pCurrent)
+        updated = *pCurrent;
+    if (updated.size() <= code)
+        updated.resize(code + 1);
+    updated[code] = options;
+    std::atomic_store(&m_typeOptions, EventTypeOptionsList(std::make_shared<const EventTypeOptionsVec>(std::move(updated))));
+} //> publishTypeOptions(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::setEventLane(Type eventCode, EventLane lane)
+{
+    if (eventCode == Type::Invalid || !CallbacksBindingMap::isDense(eventCode))
         return false;
     const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-    auto &callbacksVec = m_eventBinds[eventCode];
-    if (callbacksVec.empty())
-        return false;
-    auto cit = callbacksVec.begin(), end = callbacksVec.end();
-    for (; cit != end; cit++)
-    {
-        if (*cit == pCallback)
-        {
-            m_eventBinds[eventCode].erase(cit);
-            delete pCallback;
-            pCallback = nullptr;
-            return true;
-            break;
-        }
-    } // for each callback
+    auto options = getTypeOptions(eventCode);
+    options.lane = lane;
+    publishTypeOptions(eventCode, options);
     return true;
-} //> deleteCallback(...)
+} //> setEventLane(...)
 //>---------------------------------------------------------------------------------------
 
-size_t event::EventManager::deleteCallbacks(Type eventCode)
+event::EventLane event::EventManager::getEventLane(Type eventCode) const
 {
-    if ((int)eventCode < 0)
-        return 0;
+    return getTypeOptions(eventCode).lane;
+} //> getEventLane(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::setParallelDispatch(Type eventCode, bool toggle)
+{
+    if (eventCode == Type::Invalid || !CallbacksBindingMap::isDense(eventCode))
+        return false;
     const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-    auto &callbacksVec = m_eventBinds[eventCode];
-    if (callbacksVec.empty())
-        return 0;
-    auto cit = callbacksVec.begin(), end = callbacksVec.end();
-    size_t cnt = 0;
-    for (; cit != end; cit++)
-    {
-        auto *pCallback = *cit;
-        if (pCallback)
-            delete pCallback;
-        *cit = nullptr;
-        cnt++;
-    } //> for each callback
-    callbacksVec.clear();
-    return cnt;
-} //> deleteCallbacks(...)
+    auto options = getTypeOptions(eventCode);
+    options.parallel = toggle;
+    publishTypeOptions(eventCode, options);
+    return true;
+} //> setParallelDispatch(...)
 //>---------------------------------------------------------------------------------------
 
-uint32_t event::EventManager::addTimeout(util::Callback *pCallback, const int timeout, WrappedArgs &args)
+bool event::EventManager::isParallelDispatch(Type eventCode) const
 {
-    if (!pCallback)
-        return 0;
-    const std::lock_guard<std::mutex> lock(m_mutexTimers);
-    TimerEntryInfo timer(TimerEntryInfo::autoid(), 1, timeout, pCallback);
-    if (args.size() > 0)
-        timer.setArgs(std::move(args));
-    m_timerEntries.emplace(std::move(timer));
-    return m_timerEntries.back().getId();
-} //> addTimeout(...)
+    return getTypeOptions(eventCode).parallel;
+} //> isParallelDispatch(...)
 //>---------------------------------------------------------------------------------------
 
-event::TimerEntryInfo *event::EventManager::getTimer(const uint32_t id)
+bool event::EventManager::startWorkerPool(unsigned int numWorkers)
 {
-    const std::lock_guard<std::mutex> lock(m_mutexTimers);
-    for (auto &it : m_timerEntries)
-        if (it.getId() == id)
-            return &it;
-    return nullptr;
-} //> getTimer(...)
+    return m_workerPool.start(numWorkers);
+} //> startWorkerPool(...)
 //>---------------------------------------------------------------------------------------
 
-event::TimerEntryInfo const *event::EventManager::getTimer(const uint32_t id) const
+void event::EventManager::stopWorkerPool(void)
 {
-    const std::lock_guard<std::mutex> lock(m_mutexTimers);
-    for (const auto &it : m_timerEntries)
-        if (it.getId() == id)
-            return &it;
-    return nullptr;
-} //> getTimer(...)
+    m_workerPool.stop();
+} //> stopWorkerPool(...)
 //>---------------------------------------------------------------------------------------
 
-bool event::EventManager::hasTimer(const uint32_t id) const
+void event::EventManager::setEventsBudget(unsigned int maxEvents, double maxTimeMs)
 {
-    const std::lock_guard<std::mutex> lock(m_mutexTimers);
-    for (const auto &it : m_timerEntries)
-    {
-        if (it.getId() == id)
-            return true;
-    }
-    return false;
-} //> hasTimer(...)
+    m_budgetEvents.store(maxEvents);
+    m_budgetTime.store(maxTimeMs > 0.0 ? maxTimeMs : 0.0);
+} //> setEventsBudget(...)
 //>---------------------------------------------------------------------------------------
 
-bool event::EventManager::removeTimer(const uint32_t id)
+bool event::EventManager::takeCoalescedEvent(ThrownEvent &marker)
 {
-    if (!hasTimer(id)) //! Lock - timers
+    auto pSlot = loadCoalesceSlot(marker.eventCode);
+    if (!pSlot)
         return false;
-    TimerEntries output;
-    // need to go over every entry and emplace it back to the new queue if it's different
-    {
-        const std::lock_guard<std::mutex> lock(m_mutexTimers);
-        m_markedTimeouts.push_back(id);
-        for (auto &it : m_timerEntries)
-        {
-            if (it.getId() != id)
-                output.emplace(std::move(it));
-        }
-        std::swap(output, m_timerEntries);
-    }
+    const std::lock_guard<std::mutex> lock(pSlot->mutex);
+    if (pSlot->pending.empty())
+        return false;
+    marker = std::move(pSlot->pending.front());
+    pSlot->pending.pop_front();
     return true;
-} //> removeTimer(...)
+} //> takeCoalescedEvent(...)
 //>---------------------------------------------------------------------------------------
 
-size_t event::EventManager::removeTimers(const std::vector<uint32_t> &ids)
+bool event::EventManager::isRegisteredCallback(Type eventCode, util::Callback *pCallback)
 {
-    if (!ids.size())
-        return 0;
-    size_t cnt = 0;
-    for (auto &id : ids)
+    if (eventCode == event::Type::Invalid || !pCallback)
+        return false;
+    auto pCallbacks = loadCallbacks(eventCode);
+    if (pCallbacks && util::find(*pCallbacks, pCallback) >= 0)
+        return true;
+    auto pFiltered = loadFilteredCallbacks(eventCode);
+    if (!pFiltered)
+        return false;
+    for (auto &it : *pFiltered)
     {
-        if (hasTimer(id)) //! Lock - timers
-            cnt++;
+        if (util::find(it.second, pCallback) >= 0)
+            return true;
     }
-    if (!cnt)
-        return 0;
-    TimerEntries output;
-    // need to go over every entry and emplace it back to the new queue if it's different
-    /* lock mutex timers */ {
-        const std::lock_guard<std::mutex> lock(m_mutexTimers);
-        for (auto &it : m_timerEntries)
+    return false;
+} //> isRegistered(...)
+//>---------------------------------------------------------------------------------------
+
+event::Type event::EventManager::isRegisteredCallback(util::Callback *pCallback)
+{
+    if (!pCallback)
+        return event::Type::Invalid;
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    Type foundEvent = event::Type::Invalid;
+    m_eventBinds.forEach([&](Type eventCode, CallbacksList &slot)
+                         {
+        auto pCallbacks = std::atomic_load(&slot);
+        if (!pCallbacks || util::find(*pCallbacks, pCallback) < 0)
+            return false;
+        foundEvent = eventCode;
+        return true; }); //# for each bound event type
+    if (foundEvent != event::Type::Invalid)
+        return foundEvent;
+    m_filteredBinds.forEach([&](Type eventCode, FilteredCallbacksList &slot)
+                            {
+        auto pFiltered = std::atomic_load(&slot);
+        if (!pFiltered)
+            return false;
+        for (auto &it : *pFiltered)
         {
-            auto id = it.getId();
-            if (util::find(ids, id) < 0)
-                output.emplace(std::move(it));
+            if (util::find(it.second, pCallback) >= 0)
+            {
+                foundEvent = eventCode;
+                return true;
+            }
         }
-        std::swap(output, m_timerEntries);
-    }
-    return cnt;
-} //> removeTimers(...)
+        return false; }); //# for each filtered event type
+    return foundEvent;
+} //> isRegistered(...)
 //>---------------------------------------------------------------------------------------
 
-size_t event::EventManager::removeInactiveTimers(void)
+event::CallbacksList event::EventManager::loadCallbacks(Type eventCode) const
 {
-    std::vector<uint32_t> ids;
+    if (!CallbacksBindingMap::isDense(eventCode))
     {
-        const std::lock_guard<std::mutex> lock(m_mutexTimers);
-        for (const auto &it : m_timerEntries)
-        {
-            if (it.isInactive())
-                ids.push_back(it.getId());
-        }
+        // sparse fallback is a node based map - needs the lock for lookup
+        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+        auto pSlot = m_eventBinds.find(eventCode);
+        return pSlot ? std::atomic_load(pSlot) : CallbacksList();
     }
-    return removeTimers(ids);
-} //> removeInactiveTimers(...)
+    auto pSlot = m_eventBinds.find(eventCode);
+    if (!pSlot)
+        return CallbacksList();
+    return std::atomic_load(pSlot);
+} //> loadCallbacks(...)
 //>---------------------------------------------------------------------------------------
 
-bool event::EventManager::removeTimer(const util::Callback *pCallback)
+void event::EventManager::publishCallbacks(Type eventCode, CallbacksVec &&callbacks)
 {
-    bool found = false;
-    uint32_t id = 0;
-    /* lock mutex timers */ {
+    std::atomic_store(&m_eventBinds[eventCode], std::make_shared<const CallbacksVec>(std::move(callbacks)));
+} //> publishCallbacks(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::retireCallback(util::Callback *pCallback)
+{
+    if (!pCallback)
+        return;
+    // the callback was unpublished already - dispatches registered in a later epoch
+    // can't see it
+    m_retiredCallbacks.push_back(RetiredCallback{pCallback, m_dispatchEpoch.load()});
+    m_hasRetiredCallbacks.store(true);
+} //> retireCallback(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::reclaimCallbacks(void)
+{
+    CallbacksVec reclaimed;
+    /* lock mutex event binds */ {
+        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+        // Second round - the epoch was moved on, the dispatches of the previous one
+        // might be finished already
+        for (int round = 0; round < 2 && !m_retiredCallbacks.empty(); round++)
+        {
+            const auto epoch = m_dispatchEpoch.load();
+            // dispatches of the previous epoch (same parity as the next one) still run
+            if (m_activeDispatches[(epoch + 1) & 1].load() != 0)
+                break;
+            auto first = std::partition(m_retiredCallbacks.begin(), m_retiredCallbacks.end(), [epoch](const RetiredCallback &retired)
+                                        { return retired.epoch >= epoch; });
+            for (auto it = first; it != m_retiredCallbacks.end(); it++)
+                reclaimed.push_back(it->pCallback);
+            m_retiredCallbacks.erase(first, m_retiredCallbacks.end());
+            if (m_retiredCallbacks.empty())
+                break;
+            // the rest was retired in this epoch - new dispatches go to the other counter
+            m_dispatchEpoch.store(epoch + 1);
+        }
+        m_hasRetiredCallbacks.store(!m_retiredCallbacks.empty());
+    }
+    for (auto pCallback : reclaimed)
+        delete pCallback;
+} //> reclaimCallbacks(...)
+//>---------------------------------------------------------------------------------------
+
+uint64_t event::EventManager::enterDispatch(void)
+{
+    // Counter is raised before the snapshot is taken. The epoch is checked again - if it
+    // moved on in between, reclaim could have missed this dispatch.
+    while (true)
+    {
+        const auto epoch = m_dispatchEpoch.load();
+        auto &active = m_activeDispatches[epoch & 1];
+        active.fetch_add(1);
+        if (m_dispatchEpoch.load() == epoch)
+            return epoch;
+        active.fetch_sub(1);
+    }
+} //> enterDispatch(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::leaveDispatch(uint64_t epoch)
+{
+    if (m_activeDispatches[epoch & 1].fetch_sub(1) == 1 && m_hasRetiredCallbacks.load())
+        reclaimCallbacks(); //! Lock - event binds
+} //> leaveDispatch(...)
+//>---------------------------------------------------------------------------------------
+
+int64_t event::EventManager::metricsClock(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+} //> metricsClock(...)
+//>---------------------------------------------------------------------------------------
+
+event::EventTypeMetrics *event::EventManager::acquireMetrics(Type eventCode)
+{
+    if (EventMetricsTable::isDense(eventCode))
+    {
+        auto pSlot = m_metrics.find(eventCode);
+        if (pSlot)
+        {
+            auto pMetrics = std::atomic_load(pSlot);
+            if (pMetrics)
+                return pMetrics.get(); // metrics are kept until destroy()
+        }
+    }
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    auto &slot = m_metrics[eventCode];
+    if (!slot)
+        std::atomic_store(&slot, std::make_shared<EventTypeMetrics>());
+    return slot.get();
+} //> acquireMetrics(...)
+//>---------------------------------------------------------------------------------------
+
+event::EventTypeMetrics const *event::EventManager::getEventMetrics(Type eventCode) const
+{
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    auto pSlot = m_metrics.find(eventCode);
+    return pSlot ? pSlot->get() : nullptr;
+} //> getEventMetrics(...)
+//>---------------------------------------------------------------------------------------
+
+std::vector<event::Type> event::EventManager::getMeasuredEventTypes(void) const
+{
+    std::vector<Type> types;
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    const_cast<EventMetricsTable &>(m_metrics).forEach([&types](Type eventCode, std::shared_ptr<EventTypeMetrics> &slot)
+                                                       {
+        if (slot)
+            types.push_back(eventCode);
+        return false; });
+    return types;
+} //> getMeasuredEventTypes(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::resetEventMetrics(void)
+{
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    m_metrics.forEach([](Type eventCode, std::shared_ptr<EventTypeMetrics> &slot)
+                      {
+        if (slot)
+            slot->reset();
+        return false; });
+} //> resetEventMetrics(...)
+//>---------------------------------------------------------------------------------------
+
+event::Type event::EventManager::registerEventType(std::string_view name)
+{
+    auto standard = magic_enum::enum_cast<Type>(name);
+    if (standard.has_value())
+        return standard.value();
+    return m_eventTypes.add(name);
+} //> registerEventType(...)
+//>---------------------------------------------------------------------------------------
+
+event::Type event::EventManager::findEventType(std::string_view name) const
+{
+    auto standard = magic_enum::enum_cast<Type>(name);
+    if (standard.has_value())
+        return standard.value();
+    return m_eventTypes.find(name);
+} //> findEventType(...)
+//>---------------------------------------------------------------------------------------
+
+std::string event::EventManager::getEventTypeName(Type eventCode) const
+{
+    if (magic_enum::enum_contains<Type>(eventCode))
+        return std::string(magic_enum::enum_name<Type>(eventCode));
+    return m_eventTypes.name(eventCode);
+} //> getEventTypeName(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::invokeCallback(void *context, void *data)
+{
+    auto pArgs = reinterpret_cast<const WrappedArgs *>(context);
+    auto pCallback = reinterpret_cast<util::Callback *>(data);
+    if (pArgs && pArgs->size())
+        (*pCallback)(*pArgs);
+    else
+        (*pCallback)();
+} //> invokeCallback(...)
+//>---------------------------------------------------------------------------------------
+
+unsigned int event::EventManager::dispatch(Type eventCode, const WrappedArgs *pArgs, const util::Callback *pExclude)
+{
+    // Retired callbacks are not deleted until all dispatches that could have seen them
+    // are finished (see reclaimCallbacks)
+    const auto epoch = enterDispatch();
+    unsigned int count = 0;
+    auto pMetrics = m_metricsEnabled.load(std::memory_order_relaxed) ? acquireMetrics(eventCode) : nullptr;
+    const auto startNs = pMetrics ? metricsClock() : 0;
+    auto pCallbacks = loadCallbacks(eventCode);
+    // Filtered callbacks - only the ones bound to the key carried by the event
+    FilteredCallbacksList filteredHolder;
+    const CallbacksVec *pFiltered = nullptr;
+    if (m_hasFilters.load(std::memory_order_relaxed))
+        pFiltered = findFilteredCallbacks(eventCode, pArgs, filteredHolder);
+    // Key combination bindings - single lookup by the key code
+    KeyBindingsList keyBindings;
+    uint8_t keyModMask = 0;
+    if (m_hasKeyBindings.load(std::memory_order_relaxed))
+    {
+        auto pKeyBindingMap = getKeyBindingMap(eventCode);
+        auto pEvent = pKeyBindingMap ? getArgumentEventStruct(pArgs) : nullptr;
+        const auto code = pEvent ? static_cast<std::size_t>(pEvent->key.keyCode) : NUM_KEY_BINDING_CODES;
+        if (code < NUM_KEY_BINDING_CODES)
+        {
+            keyBindings = std::atomic_load(&(*pKeyBindingMap)[code]);
+            keyModMask = getKeyModMask(pEvent->key.mod);
+        }
+    }
+    const CallbacksVec *lists[2] = {pCallbacks.get(), pFiltered};
+    if (pCallbacks || pFiltered || keyBindings)
+    {
+        const bool usePool = m_workerPool.isRunning();
+        const bool parallelType = usePool && isParallelDispatch(eventCode);
+        util::WorkerPool::WaitGroup group;
+        auto call = [&](util::Callback *callback)
+        {
+            if (callback == pExclude)
+                return;
+            count++;
+            if (usePool && (parallelType || callback->isParallel()))
+            {
+                m_workerPool.submit(group, &EventManager::invokeCallback, const_cast<WrappedArgs *>(pArgs), callback);
+                return;
+            }
+            if (!pMetrics)
+            {
+                invokeCallback(const_cast<WrappedArgs *>(pArgs), callback);
+                return;
+            }
+            const auto callbackStartNs = metricsClock();
+            invokeCallback(const_cast<WrappedArgs *>(pArgs), callback);
+            const auto elapsed = static_cast<uint64_t>(metricsClock() - callbackStartNs);
+            pMetrics->callbackTime.record(elapsed);
+            auto slowest = pMetrics->slowestCallbackTime.load(std::memory_order_relaxed);
+            while (elapsed > slowest && !pMetrics->slowestCallbackTime.compare_exchange_weak(slowest, elapsed))
+                continue;
+            if (elapsed > slowest)
+                pMetrics->slowestCallback.store(callback, std::memory_order_relaxed);
+        };
+        for (auto pList : lists)
+        {
+            if (!pList)
+                continue;
+            for (auto callback : *pList)
+            {
+                if (callback)
+                    call(callback);
+            }
+        } //> for each callbacks list
+        if (keyBindings)
+        {
+            for (auto &binding : *keyBindings)
+            {
+                if (binding.callback && binding.modMask == keyModMask)
+                    call(binding.callback);
+            }
+        }
+        // join - arguments are released right after the dispatch
+        m_workerPool.wait(group);
+    }
+#if defined(FG_EVENT_COROUTINES)
+    if (m_eventWaitersCount.load(std::memory_order_acquire))
+        count += resumeEventWaiters(eventCode, pArgs); //! Lock - event binds
+#endif
+    if (pMetrics)
+    {
+        pMetrics->dispatched.fetch_add(1, std::memory_order_relaxed);
+        pMetrics->callbacks.fetch_add(count, std::memory_order_relaxed);
+        pMetrics->dispatchTime.record(static_cast<uint64_t>(metricsClock() - startNs));
+    }
+    leaveDispatch(epoch);
+    return count;
+} //> dispatch(...)
+//>---------------------------------------------------------------------------------------
+
+unsigned int event::EventManager::executeEvent(Type eventCode)
+{
+    return dispatch(eventCode, nullptr);
+} //> executeEvent(...)
+//>---------------------------------------------------------------------------------------
+
+unsigned int event::EventManager::executeEvent(ThrownEvent &thrownEvent)
+{
+    if (thrownEvent.queuedNs && m_metricsEnabled.load(std::memory_order_relaxed))
+        acquireMetrics(thrownEvent.eventCode)->queueWait.record(static_cast<uint64_t>(metricsClock() - thrownEvent.queuedNs));
+    util::ArgsView view(thrownEvent.args); // pointer list without allocation
+    auto count = dispatch(thrownEvent.eventCode, &view.get());
+    //
+    // Thrown event arguments need to be reset/removed after all events are processed.
+    // If there is an event structure on the argument's list, it will be retrieved and
+    // added back to the free list;
+    resetArguments(thrownEvent.args);
+    return count;
+} //> executeEvent(...)
+//>---------------------------------------------------------------------------------------
+
+unsigned int event::EventManager::executeEvent(Type eventCode, WrappedArgs &args)
+{
+    auto count = dispatch(eventCode, &args);
+    resetArguments(args);
+    return count;
+} //> executeEvent(...)
+//>---------------------------------------------------------------------------------------
+
+unsigned int event::EventManager::forwardEvent(Type eventCode, const WrappedArgs &args, const util::Callback *pExclude)
+{
+    return dispatch(eventCode, &args, pExclude);
+} //> forwardEvent(...)
+//>---------------------------------------------------------------------------------------
+
+std::size_t event::EventManager::getCallbacksCount(Type eventCode) const
+{
+    std::size_t count = 0;
+    auto pCallbacks = loadCallbacks(eventCode);
+    if (pCallbacks)
+    {
+        for (auto callback : *pCallbacks)
+        {
+            if (callback)
+                count++;
+        }
+    }
+    auto pFiltered = loadFilteredCallbacks(eventCode);
+    if (pFiltered)
+    {
+        for (auto &it : *pFiltered)
+            count += it.second.size();
+    }
+    return count;
+} //> getCallbacksCount(...)
+//>---------------------------------------------------------------------------------------
+
+util::Callback *event::EventManager::addCallback(util::Callback *pCallback, Type eventCode)
+{
+    if (!pCallback || (int)eventCode < 0)
+        return nullptr;
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    auto pCallbacks = std::atomic_load(&m_eventBinds[eventCode]);
+    CallbacksVec callbacks;
+    if (pCallbacks)
+    {
+        // Duplicate callbacks are not allowed for the same event (avoid double trigger)
+        if (util::find(*pCallbacks, pCallback) >= 0)
+            return nullptr;
+        callbacks.reserve(pCallbacks->size() + 1);
+        callbacks.assign(pCallbacks->begin(), pCallbacks->end());
+    }
+    callbacks.push_back(pCallback);
+    publishCallbacks(eventCode, std::move(callbacks));
+    return pCallback;
+} //> addCallback(...)
+//>---------------------------------------------------------------------------------------
+
+util::Callback *event::EventManager::addCallback(util::Callback *pCallback, Type eventCode, EventFilter filter)
+{
+    if (!pCallback || (int)eventCode < 0 || !isFilterableEventType(eventCode))
+        return nullptr;
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    auto &slot = m_filteredBinds[eventCode];
+    auto pFiltered = std::atomic_load(&slot);
+    auto filtered = pFiltered ? std::make_shared<FilteredCallbacks>(*pFiltered) : std::make_shared<FilteredCallbacks>();
+    auto &callbacks = (*filtered)[filter.key];
+    // Duplicate callbacks are not allowed for the same key (avoid double trigger)
+    if (util::find(callbacks, pCallback) >= 0)
+        return nullptr;
+    callbacks.push_back(pCallback);
+    std::atomic_store(&slot, FilteredCallbacksList(std::move(filtered)));
+    m_hasFilters.store(true);
+    return pCallback;
+} //> addCallback(...)
+//>---------------------------------------------------------------------------------------
+
+event::FilteredCallbacksList event::EventManager::loadFilteredCallbacks(Type eventCode) const
+{
+    if (!FilteredBindingMap::isDense(eventCode))
+    {
+        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+        auto pSlot = m_filteredBinds.find(eventCode);
+        return pSlot ? std::atomic_load(pSlot) : FilteredCallbacksList();
+    }
+    auto pSlot = m_filteredBinds.find(eventCode);
+    if (!pSlot)
+        return FilteredCallbacksList();
+    return std::atomic_load(pSlot);
+} //> loadFilteredCallbacks(...)
+//>---------------------------------------------------------------------------------------
+
+const event::CallbacksVec *event::EventManager::findFilteredCallbacks(Type eventCode, const WrappedArgs *pArgs,
+                                                                    FilteredCallbacksList &holder) const
+{
+    holder = loadFilteredCallbacks(eventCode);
+    if (!holder || holder->empty())
+        return nullptr;
+    auto pEvent = getArgumentEventStruct(pArgs);
+    uint32_t key = 0;
+    if (!pEvent || !getEventFilterKey(eventCode, *pEvent, key))
+        return nullptr;
+    auto found = holder->find(key);
+    return found != holder->end() ? &found->second : nullptr;
+} //> findFilteredCallbacks(...)
+//>---------------------------------------------------------------------------------------
+
+const event::EventCombined *event::EventManager::getArgumentEventStruct(const WrappedArgs *pArgs) const
+{
+    if (!pArgs || pArgs->empty() || !(*pArgs)[0] || !(*pArgs)[0]->isExternal())
+        return nullptr;
+    // Only structures from the pool are inspected - the pointer is checked before use
+    auto pointer = (*pArgs)[0]->getExternalPointer<void>();
+    if (!pointer || !m_eventStructs.owns(pointer))
+        return nullptr;
+    return reinterpret_cast<const EventCombined *>(pointer);
+} //> getArgumentEventStruct(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::removeFilteredCallback(Type eventCode, util::Callback *pCallback)
+{
+    auto pSlot = m_filteredBinds.find(eventCode);
+    if (!pSlot)
+        return false;
+    auto pFiltered = std::atomic_load(pSlot);
+    if (!pFiltered)
+        return false;
+    for (auto &it : *pFiltered)
+    {
+        if (util::find(it.second, pCallback) < 0)
+            continue;
+        auto filtered = std::make_shared<FilteredCallbacks>(*pFiltered);
+        auto &callbacks = (*filtered)[it.first];
+        callbacks.erase(std::remove(callbacks.begin(), callbacks.end(), pCallback), callbacks.end());
+        if (callbacks.empty())
+            filtered->erase(it.first);
+        std::atomic_store(pSlot, FilteredCallbacksList(std::move(filtered)));
+        return true;
+    } //> for each filter key
+    return false;
+} //> removeFilteredCallback(...)
+//>---------------------------------------------------------------------------------------
+
+event::CallbacksVec event::EventManager::takeFilteredCallbacks(Type eventCode)
+{
+    CallbacksVec callbacks;
+    auto pSlot = m_filteredBinds.find(eventCode);
+    if (!pSlot)
+        return callbacks;
+    auto pFiltered = std::atomic_exchange(pSlot, FilteredCallbacksList());
+    if (!pFiltered)
+        return callbacks;
+    for (auto &it : *pFiltered)
+        callbacks.insert(callbacks.end(), it.second.begin(), it.second.end());
+    return callbacks;
+} //> takeFilteredCallbacks(...)
+//>---------------------------------------------------------------------------------------
+
+event::KeyBindingMap *event::EventManager::getKeyBindingMap(Type eventCode) noexcept
+{
+    if (eventCode == Type::KeyDown)
+        return &m_keyDownBindings;
+    if (eventCode == Type::KeyUp)
+        return &m_keyUpBindings;
+    return nullptr;
+} //> getKeyBindingMap(...)
+//>---------------------------------------------------------------------------------------
+
+const event::KeyBindingMap *event::EventManager::getKeyBindingMap(Type eventCode) const noexcept
+{
+    return const_cast<self_type *>(this)->getKeyBindingMap(eventCode);
+} //> getKeyBindingMap(...)
+//>---------------------------------------------------------------------------------------
+
+util::Callback *event::EventManager::bindKey(util::Callback *pCallback, KeyCode keyCode, KeyMod mod, Type eventCode)
+{
+    auto pBindings = getKeyBindingMap(eventCode);
+    const auto code = static_cast<std::size_t>(keyCode);
+    if (!pCallback || !pBindings || code >= NUM_KEY_BINDING_CODES)
+        return nullptr;
+    const auto modMask = getKeyModMask(mod);
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    auto &slot = (*pBindings)[code];
+    auto pCurrent = std::atomic_load(&slot);
+    auto bindings = pCurrent ? std::make_shared<KeyBindingsVec>(*pCurrent) : std::make_shared<KeyBindingsVec>();
+    for (auto &binding : *bindings)
+    {
+        if (binding.callback == pCallback && binding.modMask == modMask)
+            return nullptr;
+    }
+    bindings->push_back(KeyBinding{pCallback, modMask});
+    std::atomic_store(&slot, KeyBindingsList(std::move(bindings)));
+    m_hasKeyBindings.store(true);
+    return pCallback;
+} //> bindKey(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::unbindKey(util::Callback *pCallback, KeyCode keyCode, KeyMod mod, Type eventCode)
+{
+    auto pBindings = getKeyBindingMap(eventCode);
+    const auto code = static_cast<std::size_t>(keyCode);
+    if (!pCallback || !pBindings || code >= NUM_KEY_BINDING_CODES)
+        return false;
+    const auto modMask = getKeyModMask(mod);
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    auto &slot = (*pBindings)[code];
+    auto pCurrent = std::atomic_load(&slot);
+    if (!pCurrent)
+        return false;
+    auto bindings = std::make_shared<KeyBindingsVec>();
+    bindings->reserve(pCurrent->size());
+    for (auto &binding : *pCurrent)
+    {
+        if (binding.callback != pCallback || binding.modMask != modMask)
+            bindings->push_back(binding);
+    }
+    if (bindings->size() == pCurrent->size())
+        return false;
+    std::atomic_store(&slot, bindings->empty() ? KeyBindingsList() : KeyBindingsList(std::move(bindings)));
+    return true;
+} //> unbindKey(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::isKeyBound(KeyCode keyCode, KeyMod mod, Type eventCode) const
+{
+    auto pBindings = getKeyBindingMap(eventCode);
+    const auto code = static_cast<std::size_t>(keyCode);
+    if (!pBindings || code >= NUM_KEY_BINDING_CODES)
+        return false;
+    auto pCurrent = std::atomic_load(&(*pBindings)[code]);
+    if (!pCurrent)
+        return false;
+    const auto modMask = getKeyModMask(mod);
+    for (auto &binding : *pCurrent)
+    {
+        if (binding.modMask == modMask)
+            return true;
+    }
+    return false;
+} //> isKeyBound(...)
+//>---------------------------------------------------------------------------------------
+
+size_t event::EventManager::deleteKeyBindings(void)
+{
+    size_t cnt = 0;
+    /* lock mutex event binds */ {
+        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+        CallbacksVec callbacks;
+        for (auto pBindings : {&m_keyDownBindings, &m_keyUpBindings})
+        {
+            for (auto &slot : *pBindings)
+            {
+                auto pCurrent = std::atomic_exchange(&slot, KeyBindingsList());
+                if (!pCurrent)
+                    continue;
+                for (auto &binding : *pCurrent)
+                    callbacks.push_back(binding.callback);
+            }
+        } //> for each key binding table
+        m_hasKeyBindings.store(false);
+        // The same callback can be bound to many key combinations
+        std::sort(callbacks.begin(), callbacks.end());
+        callbacks.erase(std::unique(callbacks.begin(), callbacks.end()), callbacks.end());
+        for (auto pCallback : callbacks)
+        {
+            retireCallback(pCallback);
+            cnt++;
+        } //> for each callback
+    }
+    reclaimCallbacks(); //! Lock - event binds
+    return cnt;
+} //> deleteKeyBindings(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::removeCallback(Type eventCode, util::Callback *pCallback)
+{
+    if (!pCallback || (int)eventCode < 0)
+        return false;
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    auto pSlot = m_eventBinds.find(eventCode);
+    if (!pSlot)
+        return removeFilteredCallback(eventCode, pCallback);
+    auto pCallbacks = std::atomic_load(pSlot);
+    if (!pCallbacks || util::find(*pCallbacks, pCallback) < 0)
+        return removeFilteredCallback(eventCode, pCallback);
+    CallbacksVec callbacks;
+    callbacks.reserve(pCallbacks->size());
+    for (auto callback : *pCallbacks)
+    {
+        if (callback != pCallback)
+            callbacks.push_back(callback);
+    } //> for each callback
+    publishCallbacks(eventCode, std::move(callbacks));
+    return true;
+} //> removeCallback(...)
+//>---------------------------------------------------------------------------------------
+
+event::CallbacksVec event::EventManager::removeCallbacks(Type eventCode)
+{
+    if ((int)eventCode < 0)
+        return event::CallbacksVec();
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    auto callbacks = takeFilteredCallbacks(eventCode);
+    auto pSlot = m_eventBinds.find(eventCode);
+    if (!pSlot)
+        return callbacks;
+    auto pCallbacks = std::atomic_exchange(pSlot, CallbacksList());
+    if (pCallbacks)
+        callbacks.insert(callbacks.end(), pCallbacks->begin(), pCallbacks->end());
+    return callbacks; // caller takes the ownership
+} //> removeCallbacks(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::deleteCallback(Type eventCode, util::Callback *&pCallback)
+{
+    if (!pCallback || (int)eventCode < 0)
+        return false;
+    if (!removeCallback(eventCode, pCallback)) //! Lock - event binds
+        return false;
+    /* lock mutex event binds */ {
+        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+        retireCallback(pCallback);
+    }
+    pCallback = nullptr;
+    reclaimCallbacks(); //! Lock - event binds
+    return true;
+} //> deleteCallback(...)
+//>---------------------------------------------------------------------------------------
+
+size_t event::EventManager::deleteCallbacks(Type eventCode)
+{
+    if ((int)eventCode < 0)
+        return 0;
+    size_t cnt = 0;
+    /* lock mutex event binds */ {
+        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+        auto callbacks = takeFilteredCallbacks(eventCode);
+        auto pSlot = m_eventBinds.find(eventCode);
+        auto pCallbacks = pSlot ? std::atomic_exchange(pSlot, CallbacksList()) : CallbacksList();
+        if (pCallbacks)
+            callbacks.insert(callbacks.end(), pCallbacks->begin(), pCallbacks->end());
+        if (callbacks.empty())
+            return 0;
+        for (auto pCallback : callbacks)
+        {
+            retireCallback(pCallback);
+            cnt++;
+        } //> for each callback
+    }
+    reclaimCallbacks(); //! Lock - event binds
+    return cnt;
+} //> deleteCallbacks(...)
+//>---------------------------------------------------------------------------------------
+
+uint32_t event::EventManager::pushTimer(TimerEntryInfo &&timer)
+{
+    uint32_t id = 0;
+    /* lock mutex timers */ {
+        const std::lock_guard<std::mutex> lock(m_mutexTimers);
+        id = m_timers.insert(std::move(timer));
+    }
+    // the new deadline might be earlier than the one the timer thread sleeps until
+    if (id && isTimerThreadRunning())
+        wakeTimerThread(); //! Lock - timer thread
+    return id;
+} //> pushTimer(...)
+//>---------------------------------------------------------------------------------------
+
+uint32_t event::EventManager::addTimeout(util::Callback *pCallback, const int timeout, WrappedArgs &args, const int slack)
+{
+    if (!pCallback)
+        return 0;
+    TimerEntryInfo timer(TimerEntryInfo::autoid(), 1, timeout, pCallback);
+    timer.slack = slack;
+    if (args.size() > 0)
+        timer.setArgs(std::move(args));
+    return pushTimer(std::move(timer));
+} //> addTimeout(...)
+//>---------------------------------------------------------------------------------------
+
+event::TimerEntryInfo *event::EventManager::getTimer(const uint32_t id)
+{
+    const std::lock_guard<std::mutex> lock(m_mutexTimers);
+    return m_timers.find(id);
+} //> getTimer(...)
+//>---------------------------------------------------------------------------------------
+
+event::TimerEntryInfo const *event::EventManager::getTimer(const uint32_t id) const
+{
+    const std::lock_guard<std::mutex> lock(m_mutexTimers);
+    return m_timers.find(id);
+} //> getTimer(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::hasTimer(const uint32_t id) const
+{
+    const std::lock_guard<std::mutex> lock(m_mutexTimers);
+    return m_timers.contains(id);
+} //> hasTimer(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::removeTimer(const uint32_t id)
+{
+    const std::lock_guard<std::mutex> lock(m_mutexTimers);
+    return releaseTimer(id);
+} //> removeTimer(...)
+//>---------------------------------------------------------------------------------------
+
+size_t event::EventManager::removeTimers(const std::vector<uint32_t> &ids)
+{
+    if (!ids.size())
+        return 0;
+    size_t cnt = 0;
+    const std::lock_guard<std::mutex> lock(m_mutexTimers);
+    for (auto id : ids)
+    {
+        if (releaseTimer(id))
+            cnt++;
+    }
+    return cnt;
+} //> removeTimers(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::releaseTimer(const uint32_t id)
+{
+    auto pTimer = m_timers.find(id);
+    if (!pTimer)
+        return false;
+    // Timer that is being executed right now can't be released - it will be removed
+    // at the end of processTimers(). Otherwise the slot is released right away and
+    // the schedule entry is left behind as a tombstone.
+    if (pTimer->firing)
+    {
+        pTimer->deactivate();
+        m_markedTimeouts.push_back(id);
+        return true;
+    }
+    return m_timers.erase(id);
+} //> releaseTimer(...)
+//>---------------------------------------------------------------------------------------
+
+size_t event::EventManager::removeInactiveTimers(void)
+{
+    std::vector<uint32_t> ids;
+    {
         const std::lock_guard<std::mutex> lock(m_mutexTimers);
-        for (const auto &it : m_timerEntries)
-        {
-            if (it.checkCallback(pCallback))
+        m_timers.forEach([&ids](TimerEntryInfo &timer)
+                         {
+            if (timer.isInactive() && !timer.firing)
+                ids.push_back(timer.getId()); });
+    }
+    return removeTimers(ids);
+} //> removeInactiveTimers(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::removeTimer(const util::Callback *pCallback)
+{
+    bool found = false;
+    uint32_t id = 0;
+    /* lock mutex timers */ {
+        const std::lock_guard<std::mutex> lock(m_mutexTimers);
+        m_timers.forEach([&](TimerEntryInfo &timer)
+                         {
+            if (!found && timer.checkCallback(pCallback))
             {
-                id = it.getId();
+                id = timer.getId();
                 found = true;
-                break;
-            }
-        }
+            } });
     }
     if (found)
         removeTimer(id);
@@ -475,71 +1367,726 @@ bool event::EventManager::removeTimer(const util::Callback *pCallback)
 } //> removeTimer(...)
 //>---------------------------------------------------------------------------------------
 
+bool event::EventManager::setTimerSlack(const uint32_t id, const int slack)
+{
+    const std::lock_guard<std::mutex> lock(m_mutexTimers);
+    auto pTimer = m_timers.find(id);
+    if (!pTimer)
+        return false;
+    pTimer->slack = slack > 0 ? slack : 0;
+    // the deadline only moves later, the timer thread does not need to be woken up
+    m_timers.refresh(id);
+    return true;
+} //> setTimerSlack(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::setIntervalMode(const uint32_t id, IntervalMode mode)
+{
+    const std::lock_guard<std::mutex> lock(m_mutexTimers);
+    auto pTimer = m_timers.find(id);
+    if (!pTimer || !pTimer->isInterval())
+        return false;
+    pTimer->mode = mode;
+    return true;
+} //> setIntervalMode(...)
+//>---------------------------------------------------------------------------------------
+
+uint64_t event::EventManager::getMissedPeriods(const uint32_t id) const
+{
+    const std::lock_guard<std::mutex> lock(m_mutexTimers);
+    auto pTimer = m_timers.find(id);
+    return pTimer ? pTimer->missedPeriods : 0;
+} //> getMissedPeriods(...)
+//>---------------------------------------------------------------------------------------
+
 uint32_t event::EventManager::addInterval(util::Callback *pCallback, const int interval,
-                                          const int repeats, WrappedArgs &args)
+                                          const int repeats, WrappedArgs &args, const int slack)
 {
     if (!pCallback)
         return 0;
-    const std::lock_guard<std::mutex> lock(m_mutexTimers);
     TimerEntryInfo timer(TimerEntryInfo::autoid(), repeats, interval, pCallback);
+    timer.slack = slack;
     if (args.size() > 0)
         timer.setArgs(std::move(args));
-    m_timerEntries.emplace(std::move(timer));
-    return m_timerEntries.back().getId();
+    return pushTimer(std::move(timer));
 } //> addInteval(...)
 //>---------------------------------------------------------------------------------------
 
+void event::EventManager::collectDueTimers(const int64_t timeStamp, std::vector<TimerEntryInfo *> &due)
+{
+    // Pop only the expired entries - timers that are not due are not touched at all
+    m_timers.popExpired(timeStamp, [&due](TimerEntryInfo &timer)
+                        {
+        timer.firing = true;
+        due.push_back(&timer); });
+} //> collectDueTimers(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::fireTimers(std::vector<TimerEntryInfo *> &due)
+{
+    // Callbacks are executed without the lock, so they can add/remove timers freely.
+    // The addresses of due timers remain valid (node based container, removal of
+    // firing timers is deferred).
+    auto pRecorder = m_pRecorder.load(std::memory_order_acquire);
+    for (auto timer : due)
+    {
+        for (unsigned int burst = 0; burst < MAX_CATCHUP_BURST; burst++)
+        {
+            if (pRecorder)
+                pRecorder->recordTimer(timer->getId()); //! Lock - recorder
+            timer->call();
+            if (timer->mode != IntervalMode::CatchUp)
+                break;
+            // CatchUp - the missed periods are fired right away while the deadline of
+            // the next one is already in the past (unless removed by the callback)
+            const std::lock_guard<std::mutex> lock(m_mutexTimers);
+            if (timer->isInactive() || timer->getTargetTs() > timesys::ticks())
+                break;
+        }
+    }
+    std::vector<uint32_t> markedTimeouts;
+    /* lock mutex timers */ {
+        const std::lock_guard<std::mutex> lock(m_mutexTimers);
+        for (auto timer : due)
+        {
+            timer->firing = false;
+            // expired timeouts are released in the same pass, the slot is reused
+            if (timer->isInactive())
+                m_timers.erase(timer->getId());
+            else
+                m_timers.reschedule(timer->getId());
+        }
+        due.clear();
+        markedTimeouts = std::move(m_markedTimeouts);
+        m_markedTimeouts.clear();
+    }
+    /* removes any timers that were removed while their callbacks were being executed */
+    removeTimers(markedTimeouts);
+} //> fireTimers(...)
+//>---------------------------------------------------------------------------------------
+
 void event::EventManager::processTimers(void)
 {
     //#-----------------------------------------------------------------------------------
     //# Phase 1: Intervals & timeouts - universal
     const auto timeStamp = timesys::ticks();
-    TimerEntries timerEntries;
+#if defined(FG_EVENT_COROUTINES)
+    // Sleeping coroutines are always resumed here, on the processing thread
+    if (m_hasSleepWaiters.load(std::memory_order_acquire))
+        resumeSleepWaiters(timeStamp); //! Lock - timers
+#endif
+    const bool threaded = isTimerThreadRunning();
+    if (threaded && m_timerThreadMode == TimerThreadMode::Fire)
+        return; // expired timers are fired by the timer thread
     /* lock mutex timers */ {
         const std::lock_guard<std::mutex> lock(m_mutexTimers);
-        timerEntries = std::move(m_timerEntries); // move all the contents for pending timers
-    }
-    // After timeout is executed it needs to be deleted from the timeouts pool - also the callback pointer must
-    // be freed with the argument list as they no longer needed - it will be done automatically in a separate self-owned timer
-    for (auto &timer : timerEntries)
-    {
-        if (timer.isInactive())
-            continue; // skip inactive ones
-        const auto targetTs = timer.getTargetTs();
-        // trigger callback only if target TS is met
-        if (timeStamp >= targetTs)
-            timer.call();
-    } //# for each timer
-    std::vector<uint32_t> markedTimeouts;
+        // Timers passed over by the timer thread (also leftovers after it was stopped)
+        m_dueTimers.insert(m_dueTimers.end(), m_handoffTimers.begin(), m_handoffTimers.end());
+        m_handoffTimers.clear();
+        if (!threaded)
+            collectDueTimers(timeStamp, m_dueTimers);
+    }
+    if (!m_dueTimers.empty())
+        fireTimers(m_dueTimers); //! Lock - timers
+} //> processTimers(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::startTimerThread(TimerThreadMode mode, const std::function<void(void)> &notify)
+{
+    if (isTimerThreadRunning())
+        return false;
+    m_timerThreadMode = mode;
+    m_timerNotify = notify;
+    /* lock mutex timer thread */ {
+        const std::lock_guard<std::mutex> lock(m_mutexTimerThread);
+        m_timerThreadStop = false;
+        m_timerThreadWake = false;
+    }
+    try
+    {
+        m_timerThread = std::thread(&EventManager::timerThreadMain, this);
+    }
+    catch (...)
+    {
+        return false;
+    }
+    util::setThreadName(m_timerThread, "EventTimers");
+    m_timerThreadRunning.store(true, std::memory_order_release);
+    return true;
+} //> startTimerThread(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::stopTimerThread(void)
+{
+    if (!m_timerThread.joinable())
+        return;
+    /* lock mutex timer thread */ {
+        const std::lock_guard<std::mutex> lock(m_mutexTimerThread);
+        m_timerThreadStop = true;
+    }
+    m_timerThreadCondition.notify_one();
+    m_timerThread.join();
+    m_timerThreadRunning.store(false, std::memory_order_release);
+} //> stopTimerThread(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::wakeTimerThread(void)
+{
+    /* lock mutex timer thread */ {
+        const std::lock_guard<std::mutex> lock(m_mutexTimerThread);
+        m_timerThreadWake = true;
+    }
+    m_timerThreadCondition.notify_one();
+} //> wakeTimerThread(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::timerThreadMain(void)
+{
+    std::vector<TimerEntryInfo *> due;
+    std::unique_lock<std::mutex> lock(m_mutexTimerThread);
+    while (!m_timerThreadStop)
+    {
+        int64_t deadline = INT64_MAX;
+        /* lock mutex timers */ {
+            const std::lock_guard<std::mutex> timersLock(m_mutexTimers);
+            deadline = m_timers.nextDeadline();
+        }
+        m_timerThreadWake = false; // anything pushed before is already on the schedule
+        const auto now = timesys::ticks();
+        if (deadline > now + TIMER_PRECISE_SLEEP_MS)
+        {
+            // Coarse wait - interrupted by new timers and by the stop request
+            auto predicate = [this]()
+            { return m_timerThreadStop || m_timerThreadWake; };
+            if (deadline == INT64_MAX)
+                m_timerThreadCondition.wait(lock, predicate);
+            else
+                m_timerThreadCondition.wait_for(lock, std::chrono::milliseconds(deadline - now - TIMER_PRECISE_SLEEP_MS), predicate);
+            continue;
+        }
+        lock.unlock();
+        if (deadline > now)
+            timesys::sleepUntil(deadline); // absolute deadline, no polling
+        bool handedOff = false;
+        /* lock mutex timers */ {
+            const std::lock_guard<std::mutex> timersLock(m_mutexTimers);
+            collectDueTimers(timesys::ticks(), due);
+            if (m_timerThreadMode == TimerThreadMode::Handoff && !due.empty())
+            {
+                m_handoffTimers.insert(m_handoffTimers.end(), due.begin(), due.end());
+                due.clear();
+                handedOff = true;
+            }
+        }
+        if (!due.empty())
+            fireTimers(due); //! Lock - timers
+        if (handedOff && m_timerNotify)
+            m_timerNotify();
+        lock.lock();
+    } //# while not stopped
+} //> timerThreadMain(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::collectEvents(void)
+{
+    auto pOptions = std::atomic_load(&m_typeOptions);
+    // Drain takes only the events that were queued before this call - anything thrown
+    // from within a callback is processed in the next frame (no recursive processing).
+    m_eventsQueue.drain([this, &pOptions](ThrownEvent &&thrownEvent)
+                        { pushPendingEvent(std::move(thrownEvent), pOptions); });
+    if (m_hasStagingBuffers.load(std::memory_order_acquire))
+        spliceStagedEvents(pOptions); //! Lock - staging buffers
+    if (m_hasLaneLimits.load(std::memory_order_acquire))
+        collectLimitedEvents(); //! Lock - lane limits
+} //> collectEvents(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::setLaneCapacity(EventLane lane, std::size_t capacity, OverflowPolicy policy, int blockTimeoutMs)
+{
+    const auto index = static_cast<unsigned int>(lane);
+    if (index >= NUM_EVENT_LANES)
+        return;
+    auto &limit = m_laneLimits[index];
+    /* lock mutex lane limit */ {
+        const std::lock_guard<std::mutex> lock(limit.mutex);
+        limit.capacity = capacity;
+        limit.policy = policy;
+        limit.blockTimeoutMs = blockTimeoutMs > 0 ? blockTimeoutMs : 0;
+        if (!capacity)
+        {
+            // unlimited again - the buffered events are queued before the limit is
+            // switched off, events thrown from now on are queued after them
+            for (auto &thrownEvent : limit.buffered)
+                m_eventsQueue.push(std::move(thrownEvent));
+            limit.buffered.clear();
+        }
+        limit.active.store(capacity > 0, std::memory_order_release);
+    }
+    limit.spaceCondition.notify_all();
+    bool anyActive = false;
+    for (auto &it : m_laneLimits)
+        anyActive = anyActive || it.active.load();
+    m_hasLaneLimits.store(anyActive, std::memory_order_release);
+} //> setLaneCapacity(...)
+//>---------------------------------------------------------------------------------------
+
+event::EventOverflowStats event::EventManager::getLaneOverflow(EventLane lane) const
+{
+    EventOverflowStats stats;
+    const auto index = static_cast<unsigned int>(lane);
+    if (index >= NUM_EVENT_LANES)
+        return stats;
+    auto &limit = const_cast<LaneLimit &>(m_laneLimits[index]);
+    /* lock mutex lane limit */ {
+        const std::lock_guard<std::mutex> lock(limit.mutex);
+        stats.capacity = limit.capacity;
+        stats.queued = limit.buffered.size() + limit.carried;
+    }
+    stats.dropped = limit.dropped.load(std::memory_order_relaxed);
+    stats.coalesced = limit.coalesced.load(std::memory_order_relaxed);
+    stats.blocked = limit.blocked.load(std::memory_order_relaxed);
+    return stats;
+} //> getLaneOverflow(...)
+//>---------------------------------------------------------------------------------------
+
+event::LaneLimit *event::EventManager::findLaneLimit(Type eventCode)
+{
+    auto lane = static_cast<unsigned int>(EventLane::Normal);
+    const auto code = static_cast<std::size_t>(eventCode);
+    auto pOptions = std::atomic_load(&m_typeOptions);
+    if (pOptions && code < pOptions->size())
+        lane = static_cast<unsigned int>((*pOptions)[code].lane);
+    auto &limit = m_laneLimits[lane];
+    return limit.active.load(std::memory_order_acquire) ? &limit : nullptr;
+} //> findLaneLimit(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventManager::pushLimited(LaneLimit &limit, ThrownEvent &&thrownEvent)
+{
+    ThrownEvent dropped;
+    bool accepted = true;
+    bool overflow = false;
+    // the consumer can't make space while it waits - Block works as DropNewest there
+    const bool consumer = std::this_thread::get_id() == m_processingThread.load(std::memory_order_relaxed);
+    /* lock mutex lane limit */ {
+        std::unique_lock<std::mutex> lock(limit.mutex);
+        if (limit.isFull() && limit.policy == OverflowPolicy::Block && limit.blockTimeoutMs > 0 && !consumer)
+        {
+            limit.blocked.fetch_add(1, std::memory_order_relaxed);
+            limit.spaceCondition.wait_for(lock, std::chrono::milliseconds(limit.blockTimeoutMs), [&limit]()
+                                          { return !limit.active.load() || !limit.isFull(); });
+        }
+        if (!limit.active.load())
+        {
+            // limit removed (or destroyed) while waiting
+            lock.unlock();
+            noteThrownEvent(thrownEvent); //! Lock - recorder
+            m_eventsQueue.push(std::move(thrownEvent));
+            return true;
+        }
+        if (!limit.isFull())
+        {
+            noteThrownEvent(thrownEvent); //! Lock - recorder
+            limit.buffered.push_back(std::move(thrownEvent));
+            return true;
+        }
+        overflow = true;
+        switch (limit.policy)
+        {
+        case OverflowPolicy::DropOldest:
+        {
+            // the oldest events that were collected already belong to the consumer,
+            // markers are never dropped - the coalesced event would be stuck in its slot
+            auto oldest = std::find_if(limit.buffered.begin(), limit.buffered.end(), [](const ThrownEvent &pending)
+                                       { return !pending.coalesced; });
+            if (oldest != limit.buffered.end())
+            {
+                dropped = std::move(*oldest);
+                limit.buffered.erase(oldest);
+                noteThrownEvent(thrownEvent); //! Lock - recorder
+                limit.buffered.push_back(std::move(thrownEvent));
+            }
+            else
+            {
+                dropped = std::move(thrownEvent);
+                accepted = false;
+            }
+            break;
+        }
+        case OverflowPolicy::Coalesce:
+        {
+            auto found = std::find_if(limit.buffered.rbegin(), limit.buffered.rend(), [&thrownEvent](const ThrownEvent &pending)
+                                      { return pending.eventCode == thrownEvent.eventCode && !pending.coalesced; });
+            if (found != limit.buffered.rend())
+            {
+                dropped = std::move(*found);
+                noteThrownEvent(thrownEvent); //! Lock - recorder
+                *found = std::move(thrownEvent);
+                limit.coalesced.fetch_add(1, std::memory_order_relaxed);
+                overflow = false; // merged, nothing was lost
+                break;
+            }
+            dropped = std::move(thrownEvent);
+            accepted = false;
+            break;
+        }
+        case OverflowPolicy::DropNewest:
+        case OverflowPolicy::Block:
+        default:
+            dropped = std::move(thrownEvent);
+            accepted = false;
+            break;
+        }
+    }
+    if (overflow)
+        limit.dropped.fetch_add(1, std::memory_order_relaxed);
+    // arguments of the dropped event are released without the lock
+    resetArguments(dropped.args);
+    return accepted;
+} //> pushLimited(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::queueMarker(ThrownEvent &&marker)
+{
+    if (m_hasLaneLimits.load(std::memory_order_acquire))
+    {
+        auto pLimit = findLaneLimit(marker.eventCode);
+        if (pLimit)
+        {
+            const std::lock_guard<std::mutex> lock(pLimit->mutex);
+            if (pLimit->active.load())
+            {
+                pLimit->buffered.push_back(std::move(marker));
+                return;
+            }
+        }
+    }
+    if (isThreadStaging())
+        stageEvents(&marker, 1);
+    else
+        m_eventsQueue.push(std::move(marker));
+} //> queueMarker(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::collectLimitedEvents(void)
+{
+    for (unsigned int lane = 0; lane < NUM_EVENT_LANES; lane++)
+    {
+        auto &limit = m_laneLimits[lane];
+        if (!limit.active.load(std::memory_order_acquire))
+            continue;
+        /* lock mutex lane limit */ {
+            const std::lock_guard<std::mutex> lock(limit.mutex);
+            for (auto &thrownEvent : limit.buffered)
+                m_lanes[lane].push_back(std::move(thrownEvent));
+            limit.buffered.clear();
+            limit.carried = m_lanes[lane].size();
+        }
+    } //# for each lane
+} //> collectLimitedEvents(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::releaseLaneLimits(void)
+{
+    for (unsigned int lane = 0; lane < NUM_EVENT_LANES; lane++)
+    {
+        auto &limit = m_laneLimits[lane];
+        if (!limit.active.load(std::memory_order_acquire))
+            continue;
+        /* lock mutex lane limit */ {
+            const std::lock_guard<std::mutex> lock(limit.mutex);
+            limit.carried = m_lanes[lane].size();
+        }
+        limit.spaceCondition.notify_all();
+    } //# for each lane
+} //> releaseLaneLimits(...)
+//>---------------------------------------------------------------------------------------
+
+#if defined(FG_EVENT_COROUTINES)
+void event::EventManager::addEventWaiter(Type eventCode, EventWaiter *pWaiter)
+{
+    if (!pWaiter || (int)eventCode < 0)
+        return;
+    const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+    auto &head = m_eventWaiters[eventCode];
+    pWaiter->next = head;
+    head = pWaiter;
+    m_eventWaitersCount.fetch_add(1, std::memory_order_release);
+} //> addEventWaiter(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::addSleepWaiter(EventWaiter *pWaiter)
+{
+    if (!pWaiter)
+        return;
+    auto later = [](const EventWaiter *a, const EventWaiter *b)
+    { return a->deadline > b->deadline; };
+    const std::lock_guard<std::mutex> lock(m_mutexTimers);
+    pWaiter->next = nullptr;
+    m_sleepWaiters.push_back(pWaiter);
+    std::push_heap(m_sleepWaiters.begin(), m_sleepWaiters.end(), later);
+    m_hasSleepWaiters.store(true, std::memory_order_release);
+} //> addSleepWaiter(...)
+//>---------------------------------------------------------------------------------------
+
+unsigned int event::EventManager::resumeEventWaiters(Type eventCode, const WrappedArgs *pArgs)
+{
+    EventWaiter *pWaiters = nullptr;
+    /* lock mutex event binds */ {
+        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+        auto pSlot = m_eventWaiters.find(eventCode);
+        if (!pSlot || !*pSlot)
+            return 0;
+        pWaiters = std::exchange(*pSlot, nullptr);
+    }
+    // Detached list - waiters registered again while resuming wait for the next event.
+    // Reversed first, so the waiters are resumed in the order they started waiting.
+    EventWaiter *pOrdered = nullptr;
+    unsigned int detached = 0;
+    while (pWaiters)
+    {
+        auto pNext = pWaiters->next;
+        pWaiters->next = pOrdered;
+        pOrdered = pWaiters;
+        pWaiters = pNext;
+        detached++;
+    }
+    m_eventWaitersCount.fetch_sub(detached, std::memory_order_release);
+    auto pEvent = const_cast<EventCombined *>(getArgumentEventStruct(pArgs));
+    unsigned int count = 0;
+    while (pOrdered)
+    {
+        auto pWaiter = pOrdered;
+        pOrdered = pOrdered->next; // node is not valid after resume
+        pWaiter->resume(pWaiter, pEvent);
+        count++;
+    }
+    return count;
+} //> resumeEventWaiters(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::resumeSleepWaiters(const int64_t timeStamp)
+{
+    auto later = [](const EventWaiter *a, const EventWaiter *b)
+    { return a->deadline > b->deadline; };
+    EventWaiter *pDue = nullptr;
+    EventWaiter *pLast = nullptr;
     /* lock mutex timers */ {
         const std::lock_guard<std::mutex> lock(m_mutexTimers);
-        for (auto &it : timerEntries)
-            m_timerEntries.emplace(std::move(it));
-        timerEntries.clear();
-        markedTimeouts = std::move(m_markedTimeouts);
+        while (!m_sleepWaiters.empty() && m_sleepWaiters.front()->deadline <= timeStamp)
+        {
+            std::pop_heap(m_sleepWaiters.begin(), m_sleepWaiters.end(), later);
+            auto pWaiter = m_sleepWaiters.back();
+            m_sleepWaiters.pop_back();
+            pWaiter->next = nullptr;
+            (pLast ? pLast->next : pDue) = pWaiter;
+            pLast = pWaiter;
+        }
+        m_hasSleepWaiters.store(!m_sleepWaiters.empty(), std::memory_order_release);
     }
-    /* tries to remove again any timers that might've been removed during timer entries loop */
-    removeTimers(markedTimeouts);
-} //> processTimers(...)
+    while (pDue)
+    {
+        auto pWaiter = pDue;
+        pDue = pDue->next;
+        pWaiter->resume(pWaiter, nullptr);
+    }
+} //> resumeSleepWaiters(...)
 //>---------------------------------------------------------------------------------------
 
-void event::EventManager::processEvents(void)
+void event::EventManager::cancelWaiters(void)
+{
+    std::vector<EventWaiter *> waiters;
+    /* lock mutex event binds */ {
+        const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
+        m_eventWaiters.forEach([&waiters](Type eventCode, EventWaiter *&head)
+                               {
+            for (auto pWaiter = std::exchange(head, nullptr); pWaiter; pWaiter = pWaiter->next)
+                waiters.push_back(pWaiter);
+            return false; });
+        m_eventWaiters.clear();
+        m_eventWaitersCount.store(0);
+    }
+    /* lock mutex timers */ {
+        const std::lock_guard<std::mutex> lock(m_mutexTimers);
+        waiters.insert(waiters.end(), m_sleepWaiters.begin(), m_sleepWaiters.end());
+        m_sleepWaiters.clear();
+        m_hasSleepWaiters.store(false);
+    }
+    // Frames are destroyed without the locks - destructors of the coroutine locals
+    // may call back into the manager
+    for (auto pWaiter : waiters)
+        pWaiter->cancel(pWaiter);
+} //> cancelWaiters(...)
+//>---------------------------------------------------------------------------------------
+#endif //> FG_EVENT_COROUTINES
+
+void event::EventManager::pushPendingEvent(ThrownEvent &&thrownEvent, const EventTypeOptionsList &pOptions)
+{
+    auto lane = static_cast<unsigned int>(EventLane::Normal);
+    const auto code = static_cast<std::size_t>(thrownEvent.eventCode);
+    if (pOptions && code < pOptions->size())
+        lane = static_cast<unsigned int>((*pOptions)[code].lane);
+    m_lanes[lane].push_back(std::move(thrownEvent));
+} //> pushPendingEvent(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::setThreadStaging(bool toggle)
+{
+    m_threadStaging.store(toggle, std::memory_order_release);
+} //> setThreadStaging(...)
+//>---------------------------------------------------------------------------------------
+
+std::size_t event::EventManager::getStagingBuffersCount(void) const
+{
+    const std::lock_guard<std::mutex> lock(m_mutexStaging);
+    return m_stagingBuffers.size();
+} //> getStagingBuffersCount(...)
+//>---------------------------------------------------------------------------------------
+
+event::StagingBuffer *event::EventManager::acquireStagingBuffer(void)
+{
+    const auto stagingId = m_stagingId.load(std::memory_order_acquire);
+    if (s_pStagingBuffer && s_stagingOwnerId == stagingId)
+        return s_pStagingBuffer.get();
+    const auto threadId = std::this_thread::get_id();
+    const std::lock_guard<std::mutex> lock(m_mutexStaging);
+    std::shared_ptr<StagingBuffer> pBuffer;
+    // Thread used with another manager in between, or a new thread reusing the id
+    for (auto &pExisting : m_stagingBuffers)
+    {
+        if (pExisting->owner == threadId)
+        {
+            pBuffer = pExisting;
+            break;
+        }
+    }
+    if (!pBuffer)
+    {
+        pBuffer = std::make_shared<StagingBuffer>(threadId);
+        m_stagingBuffers.push_back(pBuffer);
+        m_hasStagingBuffers.store(true, std::memory_order_release);
+    }
+    s_pStagingBuffer = pBuffer;
+    s_stagingOwnerId = stagingId;
+    return pBuffer.get();
+} //> acquireStagingBuffer(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::stageEvents(ThrownEvent *events, std::size_t count)
+{
+    auto pBuffer = acquireStagingBuffer();
+    // Throw time is the merge key - taken once for the whole block, so the block is
+    // not interleaved with events from other threads thrown at the same time
+    const auto stagedNs = events[0].queuedNs ? events[0].queuedNs : metricsClock();
+    std::unique_lock<std::mutex> lock(pBuffer->mutex);
+    while (pBuffer->retired)
+    {
+        // released by the consumer after staying idle - switch to a fresh buffer
+        lock.unlock();
+        s_pStagingBuffer.reset();
+        pBuffer = acquireStagingBuffer(); //! Lock - staging
+        lock = std::unique_lock<std::mutex>(pBuffer->mutex);
+    }
+    for (std::size_t idx = 0; idx < count; idx++)
+    {
+        events[idx].queuedNs = stagedNs;
+        pBuffer->events.push_back(std::move(events[idx]));
+    }
+} //> stageEvents(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::spliceStagedEvents(const EventTypeOptionsList &pOptions)
 {
-    EventsQueue queue;
+    /* lock mutex staging */ {
+        const std::lock_guard<std::mutex> lock(m_mutexStaging);
+        if (m_splicedEvents.size() < m_stagingBuffers.size())
+            m_splicedEvents.resize(m_stagingBuffers.size());
+        // Swap with the vectors emptied in the previous frame - capacity is reused
+        bool retired = false;
+        for (std::size_t idx = 0; idx < m_stagingBuffers.size(); idx++)
+        {
+            auto &buffer = *m_stagingBuffers[idx];
+            const std::lock_guard<std::mutex> bufferLock(buffer.mutex);
+            m_splicedEvents[idx].swap(buffer.events);
+            buffer.idleFrames = m_splicedEvents[idx].empty() ? buffer.idleFrames + 1 : 0;
+            // the buffer is empty now - producers that still hold it will move on
+            if (buffer.idleFrames >= STAGING_IDLE_FRAMES)
+                retired = buffer.retired = true;
+        }
+        if (retired)
+        {
+            m_stagingBuffers.erase(std::remove_if(m_stagingBuffers.begin(), m_stagingBuffers.end(),
+                                                  [](const std::shared_ptr<StagingBuffer> &pBuffer)
+                                                  { return pBuffer->retired; }),
+                                   m_stagingBuffers.end());
+            m_hasStagingBuffers.store(!m_stagingBuffers.empty(), std::memory_order_release);
+        }
+    }
+    // K-way merge by the throw time - the number of producer threads is small, so the
+    // heads are scanned linearly. Ties go to the lower buffer index (stable per buffer).
+    const auto numBuffers = m_splicedEvents.size();
+    std::vector<std::size_t> heads(numBuffers, 0);
+    while (true)
     {
-        // using mutex and move to another (local) queue in order to avoid recursive lock on queue
-        // if new event is thrown while executing given event
-        const std::lock_guard<std::mutex> lock(m_mutexEventsQueue);
-        queue = std::move(m_eventsQueue); // pending queue is now empty
+        std::size_t selected = numBuffers;
+        for (std::size_t idx = 0; idx < numBuffers; idx++)
+        {
+            auto &events = m_splicedEvents[idx];
+            if (heads[idx] >= events.size())
+                continue;
+            if (selected == numBuffers ||
+                events[heads[idx]].queuedNs < m_splicedEvents[selected][heads[selected]].queuedNs)
+                selected = idx;
+        }
+        if (selected == numBuffers)
+            break;
+        pushPendingEvent(std::move(m_splicedEvents[selected][heads[selected]++]), pOptions);
     }
+    for (auto &events : m_splicedEvents)
+        events.clear();
+} //> spliceStagedEvents(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventManager::processEvents(void)
+{
     //#-----------------------------------------------------------------------------------
     //# Phase 2: execution of thrown events (now including the argument list).
-    while (!queue.empty())
+    m_processingThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    collectEvents(); //! Lock - events queue (overflow only)
+    const auto maxEvents = m_budgetEvents.load();
+    const auto maxTime = m_budgetTime.load();
+    const auto startTs = maxTime > 0.0 ? timesys::ms() : 0.0;
+    unsigned int count = 0;
+    bool exhausted = false;
+    for (unsigned int lane = 0; lane < NUM_EVENT_LANES && !exhausted; lane++)
+    {
+        auto &pending = m_lanes[lane];
+        while (!pending.empty())
+        {
+            if (count && ((maxEvents && count >= maxEvents) || (maxTime > 0.0 && timesys::ms() - startTs >= maxTime)))
+            {
+                exhausted = true;
+                break;
+            }
+            ThrownEvent thrownEvent(std::move(pending.front()));
+            pending.pop_front();
+            // coalesced events are dispatched at the position of the first one, stale
+            // markers don't count towards the budget
+            if (thrownEvent.coalesced && !takeCoalescedEvent(thrownEvent))
+                continue;
+            count++;
+            m_laneStats[lane].dispatched++;
+            // this will also cleanup the allocated argument list that's associated with thrown event
+            executeEvent(thrownEvent); //! Lock - event binds
+        } //# for each pending event in lane
+    }
+    for (unsigned int lane = 0; lane < NUM_EVENT_LANES; lane++)
     {
-        // this will also cleanup the allocated argument list that's associated with thrown event
-        executeEvent(queue.front()); //! Lock - event binds
-        queue.pop();
-    } //> for each event on queue (snapshot)
+        m_laneStats[lane].depth = m_lanes[lane].size();
+        m_laneStats[lane].carriedOver += m_lanes[lane].size();
+    }
+    if (m_hasLaneLimits.load(std::memory_order_acquire))
+        releaseLaneLimits(); //! Lock - lane limits
 } //> processEvents(...)
 //>---------------------------------------------------------------------------------------
 
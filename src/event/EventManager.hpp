@@ -6,8 +6,17 @@
 
 #include <event/EventDefinitions.hpp>
 #include <event/EventHelper.hpp>
+#include <event/TimerPool.hpp>
+#include <event/EventRecorder.hpp>
+#include <event/EventTypeRegistry.hpp>
+#include <util/WorkerPool.hpp>
 
 #include <mutex>
+#include <atomic>
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <thread>
 
 namespace event
 {
@@ -21,14 +30,23 @@ namespace event
         using TimerFilterFunction = std::function<bool(const TimerEntryInfo &)>;
 
     public:
-        /// Maximum number of allocated internal event structures
-        /// When number of event structures reaches MAX and
-        /// free slots are empty - this would mean that event queue is full
+        /// Number of internal event structures preallocated on initialization
+        /// (the pool grows on demand)
         static const unsigned int MAX_EVENT_STRUCTS = 256;
-        /// Maximum number of thrown events
-        static const unsigned int MAX_THROWN_EVENTS = 256;
+        /// Number of cells in the lock-free ring for thrown events, when the ring is
+        /// full the events are kept on the (unbounded) overflow path
+        static const unsigned int MAX_THROWN_EVENTS = 1024;
         /// This is initial allocation for pointer vectors (initial capacity)
         static const unsigned int INITIAL_PTR_VEC_SIZE = 128;
+        /// The timer thread waits on a condition variable (wakes up on new timers) until
+        /// this many milliseconds before the deadline, the rest is an absolute sleep
+        static const unsigned int TIMER_PRECISE_SLEEP_MS = 2;
+        /// Staging buffers that stay empty for this many processEvents() calls are
+        /// released (threads that stopped throwing or exited)
+        static const unsigned int STAGING_IDLE_FRAMES = 120;
+        /// Maximum number of missed periods a CatchUp interval fires in a single pass,
+        /// the rest is fired in the next one
+        static const unsigned int MAX_CATCHUP_BURST = 16;
 
     public:
         /**
@@ -44,30 +62,211 @@ namespace event
         virtual bool initialize(void) override;
         virtual bool destroy(void) override;
 
+        /**
+         * Get the event structure from the pool, safe to call from any thread. The
+         * structure is released automatically when the event thrown with it as an
+         * argument is processed (or with releaseEventStruct).
+         */
         EventBase *requestEventStruct(Type eventType);
         template <typename EventStruct, Type EventType>
         EventStruct *requestEventStruct(void)
         {
             return static_cast<EventStruct *>(requestEventStruct(EventType));
         }
+        bool releaseEventStruct(EventBase *pEventStruct);
+        /**
+         * Get 'count' event structures of the same type at once (appended to the output)
+         * @return Number of structures added to the output
+         */
+        std::size_t requestEventStructs(Type eventType, std::size_t count, EventsPtrVec &output);
         //#-------------------------------------------------------------------------------
 
         /**
-         * This adds event to the waiting queue and moves the input arguments
+         * This adds event to the waiting queue and moves the input arguments.
+         * Safe to call from any thread - producers do not block each other.
          * @param eventCode
          * @param list
+         * @return True if the event was accepted (queued, staged or merged into a pending
+         *         one), false only if it was dropped by a lane with limited capacity.
+         */
+        bool throwEvent(Type eventCode, WrappedArgs &args);
+
+        /**
+         * Move the event into the waiting queue. Safe to call from any thread.
+         * @return Same as above - false if the event was dropped
+         */
+        bool throwEvent(ThrownEvent &&thrownEvent);
+
+        /**
+         * Move the block of events into the waiting queue with a single reservation (see
+         * also EventBatch). The events are not interleaved with events from other
+         * producers. Types with a coalescing policy fall back to per event throwing.
+         * @return True if all events were accepted (see throwEvent)
+         */
+        bool throwEvents(ThrownEvent *events, std::size_t count);
+        /**
+         * Release the arguments of events that won't be thrown (structures go back
+         * to the pool)
+         */
+        void discardEvents(ThrownEvent *events, std::size_t count);
+
+#if defined(FG_EVENT_COROUTINES)
+        /**
+         * Register the waiter for the next event of the given type (used by the
+         * awaitables from EventAwait.hpp). The waiter is resumed once, after the
+         * callbacks of the event were called. Safe to call from any thread.
          */
-        ThrownEvent &throwEvent(Type eventCode, WrappedArgs &args);
+        void addEventWaiter(Type eventCode, EventWaiter *pWaiter);
+        /**
+         * Register the waiter resumed by processTimers() once the deadline passes
+         * (waiter->deadline, timesys::ticks). Safe to call from any thread.
+         */
+        void addSleepWaiter(EventWaiter *pWaiter);
+#endif //> FG_EVENT_COROUTINES
+
+        /**
+         * Toggle per thread staging of thrown events (disabled by default). Every thread
+         * throws into its own buffer instead of the shared queue, the buffers are spliced
+         * once per frame by processEvents(). Events from one thread keep their order,
+         * events from different threads are merged by the time they were thrown.
+         */
+        void setThreadStaging(bool toggle);
+        inline bool isThreadStaging(void) const noexcept { return m_threadStaging.load(std::memory_order_acquire); }
+        /**
+         * Number of live staging buffers (one per recently active producer thread)
+         */
+        std::size_t getStagingBuffersCount(void) const;
 
+        /**
+         * Wrap the arguments in place (stored inline in the thrown event, no allocation
+         * per argument for up to EventArgs::INLINE_CAPACITY values) and queue the event.
+         */
         template <typename... Args>
-        ThrownEvent &throwEvent(Type eventCode, Args &&...args)
+        bool throwEvent(Type eventCode, Args &&...args)
         {
-            WrappedArgs wrapped = {util::WrappedValue::wrap(args)...};
-            return throwEvent(eventCode, wrapped);
+            ThrownEvent thrownEvent(eventCode);
+            (thrownEvent.args.push(util::WrappedValue::wrapInPlace(args)), ...);
+            return throwEvent(std::move(thrownEvent));
         }
 
         //#-------------------------------------------------------------------------------
 
+        /**
+         * Set the coalescing policy for the event type. Events of this type thrown before
+         * the next processEvents() are merged into a single one (at throw time) and it's
+         * dispatched at the position of the first one. Events that can't be merged (for
+         * example touch motion with a different finger) are queued separately.
+         */
+        void setCoalescePolicy(Type eventCode, CoalescePolicy policy);
+        CoalescePolicy getCoalescePolicy(Type eventCode) const;
+        /**
+         * @return Number of events of the given type that were merged into other ones
+         */
+        uint64_t getCoalescedCount(Type eventCode) const;
+
+        //#-------------------------------------------------------------------------------
+
+        /**
+         * Set the priority lane for the event type (Normal by default). Only the dense
+         * event codes can be assigned to a lane, other ones always use the Normal lane.
+         */
+        bool setEventLane(Type eventCode, EventLane lane);
+        EventLane getEventLane(Type eventCode) const;
+        /**
+         * Limit the work done by a single processEvents() call. Zero means no limit.
+         * At least one event is dispatched per call, events that didn't fit in the
+         * budget are carried over to the next call (order within a lane is kept).
+         * @param maxEvents Maximum number of events dispatched per call
+         * @param maxTimeMs Maximum time spent on dispatching per call (milliseconds)
+         */
+        void setEventsBudget(unsigned int maxEvents, double maxTimeMs = 0.0);
+        /**
+         * Limit the number of events waiting for dispatch in the lane (thrown and not
+         * collected yet plus carried over). Assign the event type to a lane to bound it
+         * separately. Coalescing markers are never dropped.
+         * @param capacity Maximum number of waiting events, zero - unlimited (default)
+         * @param blockTimeoutMs Maximum wait of the producer (Block policy), the event is
+         *                       dropped after that. The thread calling processEvents()
+         *                       never waits - it drops the event right away.
+         */
+        void setLaneCapacity(EventLane lane, std::size_t capacity,
+                             OverflowPolicy policy = OverflowPolicy::DropOldest,
+                             int blockTimeoutMs = 100);
+        /**
+         * Overflow counters of the lane (thread safe)
+         */
+        EventOverflowStats getLaneOverflow(EventLane lane) const;
+        /**
+         * Lane metrics - updated by processEvents(), read from the same thread
+         */
+        inline EventLaneStats const &getLaneStats(EventLane lane) const { return m_laneStats[static_cast<unsigned int>(lane)]; }
+
+        //#-------------------------------------------------------------------------------
+
+        /**
+         * Toggle collection of per type metrics (counters and latency histograms).
+         * Disabled by default - when disabled the cost is a single flag check per event.
+         */
+        inline void setMetricsEnabled(bool toggle) noexcept { m_metricsEnabled.store(toggle, std::memory_order_release); }
+        inline bool isMetricsEnabled(void) const noexcept { return m_metricsEnabled.load(std::memory_order_acquire); }
+        /**
+         * @return Metrics of the event type, null if nothing was measured for it yet
+         */
+        EventTypeMetrics const *getEventMetrics(Type eventCode) const;
+        /**
+         * @return All event types with collected metrics
+         */
+        std::vector<Type> getMeasuredEventTypes(void) const;
+        void resetEventMetrics(void);
+
+        //#-------------------------------------------------------------------------------
+
+        /**
+         * Register a named custom event type - the returned code has its own dispatch
+         * slot, so callbacks bound to it receive only events of that type. Registering
+         * the same name again returns the same code, names of standard types resolve to
+         * the standard code. Registered types are kept when the manager is destroyed.
+         * Safe to call from any thread.
+         * @return Type code or Invalid (empty name, registry full)
+         */
+        Type registerEventType(std::string_view name);
+        /**
+         * @return Code of the standard or registered type with the given name, or Invalid
+         */
+        Type findEventType(std::string_view name) const;
+        /**
+         * @return Name of the standard or registered type, empty for unknown codes
+         */
+        std::string getEventTypeName(Type eventCode) const;
+        inline bool isRegisteredEventType(Type eventCode) const { return m_eventTypes.contains(eventCode); }
+
+        //#-------------------------------------------------------------------------------
+
+        /**
+         * Attach the recorder - thrown events and timer firings are written to it while
+         * it's recording. The recorder is not owned, pass null to detach.
+         */
+        inline void setRecorder(EventRecorder *pRecorder) noexcept { m_pRecorder.store(pRecorder, std::memory_order_release); }
+        inline EventRecorder *getRecorder(void) const noexcept { return m_pRecorder.load(std::memory_order_acquire); }
+
+        //#-------------------------------------------------------------------------------
+
+        /**
+         * Start the shared worker pool - from now on parallel handlers are executed
+         * concurrently, executeEvent returns after all of them are finished (join).
+         * @param numWorkers Number of worker threads (zero - based on the number of cores)
+         */
+        bool startWorkerPool(unsigned int numWorkers = 0);
+        void stopWorkerPool(void);
+        inline util::WorkerPool &getWorkerPool(void) noexcept { return m_workerPool; }
+        /**
+         * Mark all handlers of the event type as parallel safe (dense event codes only)
+         */
+        bool setParallelDispatch(Type eventCode, bool toggle);
+        bool isParallelDispatch(Type eventCode) const;
+
+        //#-------------------------------------------------------------------------------
+
         bool isRegisteredCallback(Type eventCode, util::Callback *pCallback);
         Type isRegisteredCallback(util::Callback *pCallback);
 
@@ -82,12 +281,10 @@ namespace event
         {
             if (eventCode == Type::Invalid || !methodMember)
                 return nullptr;
-            const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-            auto found = m_eventBinds.find(eventCode);
-            if (found == m_eventBinds.end())
+            auto pCallbacks = loadCallbacks(eventCode); // snapshot, no lock
+            if (!pCallbacks)
                 return nullptr;
-            auto &callbacks = found->second;
-            for (auto callback : callbacks)
+            for (auto callback : *pCallbacks)
             {
                 if (!util::isMethodCallback(callback))
                     continue;
@@ -111,12 +308,10 @@ namespace event
         {
             if (eventCode == Type::Invalid || !function)
                 return nullptr;
-            const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-            auto found = m_eventBinds.find(eventCode);
-            if (found == m_eventBinds.end())
+            auto pCallbacks = loadCallbacks(eventCode); // snapshot, no lock
+            if (!pCallbacks)
                 return nullptr;
-            auto &callbacks = found->second;
-            for (auto callback : callbacks)
+            for (auto callback : *pCallbacks)
             {
                 if (util::isFunctionCallback(callback) &&
                     util::BindingHelper::compare<FunctionType>(callback->getBinding(), function))
@@ -137,12 +332,10 @@ namespace event
         {
             if (eventCode == Type::Invalid || !pObject)
                 return nullptr;
-            const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
-            auto found = m_eventBinds.find(eventCode);
-            if (found == m_eventBinds.end())
+            auto pCallbacks = loadCallbacks(eventCode); // snapshot, no lock
+            if (!pCallbacks)
                 return nullptr;
-            auto &callbacks = found->second;
-            for (auto callback : callbacks)
+            for (auto callback : *pCallbacks)
             {
                 if (util::isMethodCallback(callback) &&
                     static_cast<util::MethodCallback<UserClass> *>(callback)->getObject() == pObject)
@@ -165,22 +358,23 @@ namespace event
                 return Type::Invalid;
             const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
             Type foundEvent = Type::Invalid;
-            for (auto &it : m_eventBinds)
-            {
-                for (auto callback : it.second)
+            m_eventBinds.forEach([&](Type eventCode, CallbacksList &slot)
+                                 {
+                auto pCallbacks = std::atomic_load(&slot);
+                if (!pCallbacks)
+                    return false;
+                for (auto callback : *pCallbacks)
                 {
                     if (!util::isMethodCallback(callback))
                         continue;
                     auto objectEquals = static_cast<util::MethodCallback<UserClass> *>(callback)->getObject() == pObject;
                     auto methodEquals = util::BindingHelper::compare<MethodType>(callback->getBinding(), methodMember);
                     if (methodEquals && ((pObject != nullptr && objectEquals) || (pObject == nullptr)))
-                        foundEvent = it.first;
+                        foundEvent = eventCode;
                     if (foundEvent != Type::Invalid)
-                        break;
+                        return true;
                 }
-                if (foundEvent != Type::Invalid)
-                    break;
-            } //# for each bound event type
+                return false; }); //# for each bound event type
             return foundEvent;
         } //> isRegistered(...)
         //>-------------------------------------------------------------------------------
@@ -198,19 +392,20 @@ namespace event
                 return Type::Invalid;
             const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
             Type foundEvent = Type::Invalid;
-            for (auto &it : m_eventBinds)
-            {
-                for (auto callback : it.second)
+            m_eventBinds.forEach([&](Type eventCode, CallbacksList &slot)
+                                 {
+                auto pCallbacks = std::atomic_load(&slot);
+                if (!pCallbacks)
+                    return false;
+                for (auto callback : *pCallbacks)
                 {
                     if (util::isFunctionCallback(callback) &&
                         util::BindingHelper::compare<FunctionType>(callback->getBinding(), function))
-                        foundEvent = it.first;
+                        foundEvent = eventCode;
                     if (foundEvent != Type::Invalid)
-                        break;
+                        return true;
                 }
-                if (foundEvent != Type::Invalid)
-                    break;
-            } //# for each bound event type
+                return false; }); //# for each bound event type
             return foundEvent;
         } //> isRegistered(...)
         //>-------------------------------------------------------------------------------
@@ -228,19 +423,20 @@ namespace event
                 return Type::Invalid;
             const std::lock_guard<std::mutex> lock(m_mutexEventBinds);
             Type foundEvent = Type::Invalid;
-            for (auto &it : m_eventBinds)
-            {
-                for (auto callback : it.second)
+            m_eventBinds.forEach([&](Type eventCode, CallbacksList &slot)
+                                 {
+                auto pCallbacks = std::atomic_load(&slot);
+                if (!pCallbacks)
+                    return false;
+                for (auto callback : *pCallbacks)
                 {
                     if (util::isMethodCallback(callback) &&
                         static_cast<util::MethodCallback<UserClass> *>(callback)->getObject() == pObject)
-                        foundEvent = it.first;
+                        foundEvent = eventCode;
                     if (foundEvent != Type::Invalid)
-                        break;
+                        return true;
                 }
-                if (foundEvent != Type::Invalid)
-                    break;
-            } //# for each bound event type
+                return false; }); //# for each bound event type
             return foundEvent;
         } //> isRegistered(...)
         //>-------------------------------------------------------------------------------
@@ -248,26 +444,75 @@ namespace event
         unsigned int executeEvent(Type eventCode);
         unsigned int executeEvent(ThrownEvent &thrownEvent);
         unsigned int executeEvent(Type eventCode, WrappedArgs &args);
+        /**
+         * Dispatch right away without taking the ownership of the arguments (nothing is
+         * released afterwards) - used by typed signals for dynamic subscribers
+         * @param pExclude Callback that is skipped (bridge of the emitting signal)
+         */
+        unsigned int forwardEvent(Type eventCode, const WrappedArgs &args, const util::Callback *pExclude = nullptr);
+
+        /// Number of callbacks bound to the event type (including filtered ones)
+        std::size_t getCallbacksCount(Type eventCode) const;
 
         //#-------------------------------------------------------------------------------
 
+        /**
+         * Bind the callback to the event type. Callbacks marked as parallel (see
+         * util::Callback::setParallel) are executed on the worker pool when it's running.
+         */
         util::Callback *addCallback(util::Callback *pCallback, Type eventCode);
 
+        /**
+         * @param parallel Handler is independent from other handlers (thread safe) and
+         *                 can run concurrently on the worker pool
+         */
         template <typename MethodType, typename UserClass>
-        util::Callback *addCallback(Type eventCode, MethodType methodMember, UserClass *pObject)
+        util::Callback *addCallback(Type eventCode, MethodType methodMember, UserClass *pObject, bool parallel = false)
         {
             if (!methodMember || (int)eventCode < 0 || !pObject)
                 return nullptr;
-            return addCallback((util::Callback *)util::MethodCallback<UserClass>::create(methodMember, pObject), eventCode);
+            auto pCallback = (util::Callback *)util::MethodCallback<UserClass>::create(methodMember, pObject);
+            pCallback->setParallel(parallel);
+            return addCallback(pCallback, eventCode);
         }
         //>-------------------------------------------------------------------------------
 
         template <typename FunctionType>
-        util::Callback *addCallback(Type eventCode, FunctionType function)
+        util::Callback *addCallback(Type eventCode, FunctionType function, bool parallel = false)
         {
             if (!function || (int)eventCode < 0)
                 return nullptr;
-            return addCallback((util::Callback *)util::FunctionCallback::create(function), eventCode);
+            auto pCallback = (util::Callback *)util::FunctionCallback::create(function);
+            pCallback->setParallel(parallel);
+            return addCallback(pCallback, eventCode);
+        }
+        //>-------------------------------------------------------------------------------
+
+        /**
+         * Bind the callback with a pre-dispatch filter - it's called only for events that
+         * carry the same key (key code, button, resource type - see EventFilter).
+         * Filtered callbacks are indexed by the key, so an event reaches only the
+         * callbacks bound to its key.
+         */
+        util::Callback *addCallback(util::Callback *pCallback, Type eventCode, EventFilter filter);
+
+        template <typename MethodType, typename UserClass>
+        util::Callback *addCallback(Type eventCode, MethodType methodMember, UserClass *pObject, EventFilter filter)
+        {
+            if (!methodMember || (int)eventCode < 0 || !pObject)
+                return nullptr;
+            auto pCallback = (util::Callback *)util::MethodCallback<UserClass>::create(methodMember, pObject);
+            return addCallback(pCallback, eventCode, filter);
+        }
+        //>-------------------------------------------------------------------------------
+
+        template <typename FunctionType>
+        util::Callback *addCallback(Type eventCode, FunctionType function, EventFilter filter)
+        {
+            if (!function || (int)eventCode < 0)
+                return nullptr;
+            auto pCallback = (util::Callback *)util::FunctionCallback::create(function);
+            return addCallback(pCallback, eventCode, filter);
         }
         //>-------------------------------------------------------------------------------
 
@@ -286,19 +531,79 @@ namespace event
 
         //#-------------------------------------------------------------------------------
 
-        uint32_t addTimeout(util::Callback *pCallback, const int timeout, WrappedArgs &args);
+        /**
+         * Bind the callback to the key combination. Bindings are kept in a table indexed
+         * directly with the key code, so the dispatch does not go through every key
+         * handler. Side of the modifier is not distinguished (LCTRL matches RCTRL), lock
+         * keys are ignored, the modifiers have to match exactly.
+         * @param eventCode KeyDown (default) or KeyUp
+         * @return The callback or nullptr if the binding is not valid or already exists
+         */
+        util::Callback *bindKey(util::Callback *pCallback, KeyCode keyCode, KeyMod mod = KeyMod::NONE,
+                                Type eventCode = Type::KeyDown);
+
+        template <typename MethodType, typename UserClass>
+        util::Callback *bindKey(KeyCode keyCode, KeyMod mod, MethodType methodMember, UserClass *pObject,
+                                Type eventCode = Type::KeyDown)
+        {
+            if (!methodMember || !pObject)
+                return nullptr;
+            auto pCallback = (util::Callback *)util::MethodCallback<UserClass>::create(methodMember, pObject);
+            if (!bindKey(pCallback, keyCode, mod, eventCode))
+            {
+                delete pCallback;
+                return nullptr;
+            }
+            return pCallback;
+        }
+        //>-------------------------------------------------------------------------------
+
+        template <typename FunctionType>
+        util::Callback *bindKey(KeyCode keyCode, KeyMod mod, FunctionType function, Type eventCode = Type::KeyDown)
+        {
+            if (!function)
+                return nullptr;
+            auto pCallback = (util::Callback *)util::FunctionCallback::create(function);
+            if (!bindKey(pCallback, keyCode, mod, eventCode))
+            {
+                delete pCallback;
+                return nullptr;
+            }
+            return pCallback;
+        }
+        //>-------------------------------------------------------------------------------
+
+        /**
+         * Remove the binding - the callback is not deleted (caller takes the ownership)
+         */
+        bool unbindKey(util::Callback *pCallback, KeyCode keyCode, KeyMod mod = KeyMod::NONE,
+                       Type eventCode = Type::KeyDown);
+
+        bool isKeyBound(KeyCode keyCode, KeyMod mod = KeyMod::NONE, Type eventCode = Type::KeyDown) const;
+
+        /**
+         * Remove all key bindings and delete the callbacks (deferred while dispatching)
+         * @return Number of deleted callbacks
+         */
+        size_t deleteKeyBindings(void);
+
+        //#-------------------------------------------------------------------------------
+
+        /**
+         * @param slack Tolerance in milliseconds - the timer may fire up to this much later,
+         *              timers with overlapping windows are fired in one batch
+         */
+        uint32_t addTimeout(util::Callback *pCallback, const int timeout, WrappedArgs &args, const int slack = 0);
 
         template <typename FunctionType>
         uint32_t addTimeout(const int timeout, FunctionType function,
                             WrappedArgs &args = WrappedArgs(),
                             const std::initializer_list<std::string> &argNames = {})
         {
-            const std::lock_guard<std::mutex> lock(m_mutexTimers);
-            m_timerEntries.emplace(std::move(
+            return pushTimer(std::move(
                 TimerHelper::function<TimerEntryInfo::TIMEOUT, FunctionType>(
                     timeout, function, argNames)
                     .setArgs(std::move(args))));
-            return m_timerEntries.back().getId();
         }
         //>-------------------------------------------------------------------------------
 
@@ -309,12 +614,10 @@ namespace event
                             WrappedArgs &args = WrappedArgs(),
                             const std::initializer_list<std::string> &argNames = {})
         {
-            const std::lock_guard<std::mutex> lock(m_mutexTimers);
-            m_timerEntries.emplace(std::move(
+            return pushTimer(std::move(
                 TimerHelper::method<TimerEntryInfo::TIMEOUT, MethodType>(
                     timeout, pObject, methodMember, argNames)
                     .setArgs(std::move(args))));
-            return m_timerEntries.back().getId();
         }
         //>-------------------------------------------------------------------------------
 
@@ -324,13 +627,22 @@ namespace event
         inline bool hasTimers(void) const
         {
             const std::lock_guard<std::mutex> lock(m_mutexTimers);
-            return !m_timerEntries.empty();
+            return !m_timers.empty();
         }
         bool hasTimer(const uint32_t id) const;
         bool removeTimer(const uint32_t id);
         size_t removeTimers(const std::vector<uint32_t> &ids);
+        /**
+         * Release deactivated timers that are not executing - expired timeouts are
+         * released by processTimers() already, no periodic sweep is needed
+         */
         size_t removeInactiveTimers(void);
         bool removeTimer(const util::Callback *pCallback);
+        /**
+         * Change the slack (tolerance in milliseconds) of the timer - can be used for
+         * timers created with the function/method overloads too
+         */
+        bool setTimerSlack(const uint32_t id, const int slack);
 
         inline bool removeTimeout(const uint32_t id) { return removeTimer(id); };
         inline bool removeTimeout(const util::Callback *pCallback) { return removeTimer(pCallback); }
@@ -338,19 +650,18 @@ namespace event
         //#-------------------------------------------------------------------------------
 
         uint32_t addInterval(util::Callback *pCallback, const int interval,
-                             const int repeats = -1, WrappedArgs &args = WrappedArgs());
+                             const int repeats = -1, WrappedArgs &args = WrappedArgs(),
+                             const int slack = 0);
 
         template <typename FunctionType>
         uint32_t addInterval(const int interval, FunctionType function,
                              const int repeats = -1, WrappedArgs &args = WrappedArgs(),
                              const std::initializer_list<std::string> &argNames = {})
         {
-            const std::lock_guard<std::mutex> lock(m_mutexTimers);
-            m_timerEntries.emplace(std::move(
+            return pushTimer(std::move(
                 TimerHelper::function<TimerEntryInfo::INTERVAL, FunctionType>(
                     interval, function, repeats, argNames)
                     .setArgs(std::move(args))));
-            return m_timerEntries.back().getId();
         }
         //>-------------------------------------------------------------------------------
 
@@ -362,54 +673,343 @@ namespace event
                              const int repeats = -1, WrappedArgs &args = WrappedArgs(),
                              const std::initializer_list<std::string> &argNames = {})
         {
-            const std::lock_guard<std::mutex> lock(m_mutexTimers);
-            m_timerEntries.emplace(std::move(
+            return pushTimer(std::move(
                 TimerHelper::method<TimerEntryInfo::INTERVAL, MethodType>(
                     interval, pObject, methodMember, repeats, argNames)
                     .setArgs(std::move(args))));
-            return m_timerEntries.back().getId();
         }
         //>-------------------------------------------------------------------------------
 
+        /**
+         * Switch the interval between fixed delay (default) and fixed rate scheduling.
+         * Fixed rate intervals keep to the original schedule, when processing falls
+         * behind the missed periods are fired in a row (CatchUp - up to MAX_CATCHUP_BURST
+         * in one pass) or dropped (Skip).
+         */
+        bool setIntervalMode(const uint32_t id, IntervalMode mode);
+        /**
+         * @return Number of periods of the interval that were skipped or fired late by
+         *         at least a full period (fixed rate modes only)
+         */
+        uint64_t getMissedPeriods(const uint32_t id) const;
+
         inline bool removeInterval(const uint32_t id) { return removeTimer(id); };
         inline bool removeInterval(const util::Callback *pCallback) { return removeTimer(pCallback); }
 
         //#-------------------------------------------------------------------------------
 
+        /**
+         * Start the dedicated timer thread - it sleeps until the earliest deadline instead
+         * of relying on the rate of processTimers() calls (sub-millisecond latency).
+         * @param mode   Fire - callbacks are executed on the timer thread (must be thread
+         *               safe), Handoff - expired timers are executed by processTimers()
+         * @param notify Called on the timer thread after a handoff (optional, can be used
+         *               to wake up the owning thread)
+         */
+        bool startTimerThread(TimerThreadMode mode = TimerThreadMode::Fire,
+                              const std::function<void(void)> &notify = {});
+        void stopTimerThread(void);
+
+        inline bool isTimerThreadRunning(void) const noexcept { return m_timerThreadRunning.load(std::memory_order_acquire); }
+
+        inline TimerThreadMode getTimerThreadMode(void) const noexcept { return m_timerThreadMode; }
+
+        //#-------------------------------------------------------------------------------
+
         //?void addEventFilter(const EventFilterFunction &eventFilter);
         //?void addTimerFilter(const TimerFilterFunction &timerFilter);
 
         /**
          * Execute (finalized) all events waiting in a queue
          * This function must be called in every frame in one of the threads
-         * (or just the main thread)
+         * (or just the main thread). Events are dispatched lane by lane (High first)
+         * within the configured budget.
          */
         void processEventsAndTimers(void);
         void processTimers(void);
         void processEvents(void);
 
     private:
-        void pushToFreeSlot(EventBase *pEventStruct);
+        /**
+         * Move the timer into the pool and put it on the schedule (locks timers)
+         * @return Timer identifier
+         */
+        uint32_t pushTimer(TimerEntryInfo &&timer);
+        /**
+         * Release the timer slot or mark the timer for removal if its callback is being
+         * executed at the moment (timers lock must be held)
+         */
+        bool releaseTimer(const uint32_t id);
+        /**
+         * Pop the expired timers and mark them as firing (timers lock must be held)
+         */
+        void collectDueTimers(const int64_t timeStamp, std::vector<TimerEntryInfo *> &due);
+        /**
+         * Execute the due timers, put them back on the schedule and release the expired
+         * timeouts and timers removed in the meantime - the list is cleared (locks timers)
+         */
+        void fireTimers(std::vector<TimerEntryInfo *> &due);
+        void wakeTimerThread(void);
+        void timerThreadMain(void);
         void resetArguments(WrappedArgs &args);
+        void resetArguments(EventArgs &args);
+        /**
+         * Release the event structure if the wrapped value points to one from the pool
+         */
+        void releaseArgument(util::WrappedValue *pValue);
+
+        std::shared_ptr<CoalesceSlot> loadCoalesceSlot(Type eventCode) const;
+        /**
+         * @return True if any of the events has an active coalescing policy
+         */
+        bool hasCoalescing(ThrownEvent *events, std::size_t count) const;
+        /**
+         * Merge the incoming event into the pending one according to the policy
+         * @return False if the events are not compatible (need to be dispatched separately)
+         */
+        bool mergeEvents(ThrownEvent &pending, ThrownEvent &incoming, CoalescePolicy policy);
+        /**
+         * Replace the marker with the pending event from the coalescing slot
+         * @return False if there's nothing to dispatch
+         */
+        bool takeCoalescedEvent(ThrownEvent &marker);
+        /**
+         * Move the events from the queue to the lanes (only those thrown before the call)
+         */
+        void collectEvents(void);
+#if defined(FG_EVENT_COROUTINES)
+        /**
+         * Resume the coroutines waiting for the event type
+         * @return Number of resumed waiters
+         */
+        unsigned int resumeEventWaiters(Type eventCode, const WrappedArgs *pArgs);
+        /**
+         * Resume the sleeping coroutines with the deadline before the time stamp
+         */
+        void resumeSleepWaiters(const int64_t timeStamp);
+        /**
+         * Destroy all suspended coroutines (called from destroy)
+         */
+        void cancelWaiters(void);
+#endif //> FG_EVENT_COROUTINES
+        /**
+         * Limited lane of the event type (null if the lane has no capacity set)
+         */
+        LaneLimit *findLaneLimit(Type eventCode);
+        /**
+         * Append the event to the limited lane applying the overflow policy
+         * Admitted events are counted and recorded (see noteThrownEvent).
+         * @return False if the event was dropped
+         */
+        bool pushLimited(LaneLimit &limit, ThrownEvent &&thrownEvent);
+        /**
+         * Queue the marker of a coalesced event. Markers of limited lanes go through the
+         * lane buffer (regardless of the capacity), so they keep their position among
+         * the other events of the lane.
+         */
+        void queueMarker(ThrownEvent &&marker);
+        /**
+         * Update the metrics and pass the event to the recorder - called once the event
+         * is admitted (dropped events are not counted)
+         */
+        void noteThrownEvent(ThrownEvent &thrownEvent);
+        /**
+         * Move the buffered events of limited lanes to the lanes (collectEvents)
+         */
+        void collectLimitedEvents(void);
+        /**
+         * Publish the number of carried over events and wake blocked producers
+         */
+        void releaseLaneLimits(void);
+        /**
+         * Staging buffer of the calling thread (created on first use, replaced when
+         * the cached one was retired)
+         */
+        StagingBuffer *acquireStagingBuffer(void);
+        /**
+         * Append the event to the staging buffer of the calling thread
+         */
+        void stageEvents(ThrownEvent *events, std::size_t count);
+        /**
+         * Move staged events from all buffers to the lanes, merged by the throw time
+         */
+        void spliceStagedEvents(const EventTypeOptionsList &pOptions);
+        /**
+         * Push the event to the lane matching its type
+         */
+        void pushPendingEvent(ThrownEvent &&thrownEvent, const EventTypeOptionsList &pOptions);
+        /**
+         * Options of the event type from the current snapshot (defaults if not set)
+         */
+        EventTypeOptions getTypeOptions(Type eventCode) const;
+        /**
+         * Publish a new snapshot of the type options (event binds lock must be held)
+         */
+        void publishTypeOptions(Type eventCode, const EventTypeOptions &options);
+
+        /**
+         * Take the current snapshot of callbacks for the event type (lock free)
+         * @return Null if nothing was ever registered for this type
+         */
+        CallbacksList loadCallbacks(Type eventCode) const;
+        /**
+         * Publish a new version of the callbacks list (event binds lock must be held)
+         */
+        void publishCallbacks(Type eventCode, CallbacksVec &&callbacks);
+        /**
+         * Take the current snapshot of filtered callbacks for the event type (lock free)
+         */
+        FilteredCallbacksList loadFilteredCallbacks(Type eventCode) const;
+        /**
+         * Find the filtered callbacks matching the key carried by the event arguments
+         * (first argument - event structure from the pool)
+         * @param holder Keeps the snapshot alive while the returned list is used
+         */
+        const CallbacksVec *findFilteredCallbacks(Type eventCode, const WrappedArgs *pArgs,
+                                                  FilteredCallbacksList &holder) const;
+        /**
+         * Remove the callback from the filtered index (event binds lock must be held)
+         */
+        bool removeFilteredCallback(Type eventCode, util::Callback *pCallback);
+        /**
+         * Detach all filtered callbacks of the event type (event binds lock must be held)
+         */
+        CallbacksVec takeFilteredCallbacks(Type eventCode);
+        /**
+         * Event structure passed as the first argument (only if it comes from the pool)
+         */
+        const EventCombined *getArgumentEventStruct(const WrappedArgs *pArgs) const;
+        /**
+         * Key binding table for the event type (KeyDown / KeyUp), nullptr otherwise
+         */
+        KeyBindingMap *getKeyBindingMap(Type eventCode) noexcept;
+        const KeyBindingMap *getKeyBindingMap(Type eventCode) const noexcept;
+        /**
+         * Queue the callback for deletion - it might still be referenced by a snapshot
+         * used in a dispatch that is in progress (event binds lock must be held)
+         */
+        void retireCallback(util::Callback *pCallback);
+        /**
+         * Delete the retired callbacks that no dispatch in progress can see - all
+         * dispatches registered in their epoch (or earlier) finished (locks event binds)
+         */
+        void reclaimCallbacks(void);
+        /**
+         * Register the dispatch in the current epoch
+         * @return Epoch to pass to leaveDispatch
+         */
+        uint64_t enterDispatch(void);
+        void leaveDispatch(uint64_t epoch);
+
+        /**
+         * Execute all callbacks bound to the event type - parallel ones on the worker
+         * pool (joined before returning), the rest on the calling thread.
+         * @param pArgs Arguments for the callbacks, null or empty - no arguments
+         * @param pExclude Callback that is not executed (not counted either)
+         * @return Number of executed callbacks
+         */
+        unsigned int dispatch(Type eventCode, const WrappedArgs *pArgs, const util::Callback *pExclude = nullptr);
+        static void invokeCallback(void *context, void *data);
+        /**
+         * Get (or create) the metrics of the event type - locks event binds on first use
+         */
+        EventTypeMetrics *acquireMetrics(Type eventCode);
+        /// Monotonic time in nanoseconds for metrics
+        static int64_t metricsClock(void);
 
     private:
         /// Binding for all global events
         CallbacksBindingMap m_eventBinds;
-        /// Events queue (message queue so to speak)
+        /// Callbacks with pre-dispatch filters, indexed by the filter key
+        FilteredBindingMap m_filteredBinds;
+        /// Set once any filtered callback was bound - skips the key lookup otherwise
+        std::atomic_bool m_hasFilters;
+        /// Key combination bindings for KeyDown and KeyUp events
+        KeyBindingMap m_keyDownBindings;
+        KeyBindingMap m_keyUpBindings;
+        /// Set once any key was bound
+        std::atomic_bool m_hasKeyBindings;
+        /// Events queue (message queue so to speak) - lock-free MPSC ring
         EventsQueue m_eventsQueue;
-        /// Pool with timers - these are one shot timeouts and intervals
-        TimerEntries m_timerEntries;
-        ///
-        uint32_t m_cleanupIntervalId;
+        /// Coalescing slots per event type (written under the event binds lock)
+        CoalesceSlots m_coalesceSlots;
+        /// Set once any coalescing policy was configured - skips the lookup otherwise
+        std::atomic_bool m_hasCoalescing;
+        /// Lane and dispatch options per event type (written under the event binds lock)
+        EventTypeOptionsList m_typeOptions;
+#if defined(FG_EVENT_COROUTINES)
+        /// Coroutines waiting for events (guarded by the event binds lock)
+        EventWaitersTable m_eventWaiters;
+        /// Number of registered event waiters - dispatch skips the table while it's zero
+        std::atomic<unsigned int> m_eventWaitersCount;
+        /// Sleeping coroutines - min-heap by deadline (guarded by the timers lock)
+        std::vector<EventWaiter *> m_sleepWaiters;
+        std::atomic_bool m_hasSleepWaiters;
+#endif //> FG_EVENT_COROUTINES
+        /// Per thread staging buffers (see setThreadStaging), list guarded by the staging lock
+        std::vector<std::shared_ptr<StagingBuffer>> m_stagingBuffers;
+        /// Events moved out of the staging buffers (consumer side only, reused every frame)
+        std::vector<std::vector<ThrownEvent>> m_splicedEvents;
+        mutable std::mutex m_mutexStaging;
+        std::atomic_bool m_threadStaging;
+        std::atomic_bool m_hasStagingBuffers;
+        /// Identifies the buffers of this manager in the per thread cache (renewed on destroy)
+        std::atomic<uint64_t> m_stagingId;
+        /// Thread that called processEvents() last - producers on it never block
+        std::atomic<std::thread::id> m_processingThread;
+        /// Staging buffer of the current thread - valid only if the manager id matches,
+        /// the reference keeps a retired buffer alive until the thread switches or exits
+        inline static thread_local std::shared_ptr<StagingBuffer> s_pStagingBuffer;
+        inline static thread_local uint64_t s_stagingOwnerId = 0;
+        inline static std::atomic<uint64_t> s_stagingIds{0};
+        /// Bounded intake per lane (see setLaneCapacity)
+        std::array<LaneLimit, NUM_EVENT_LANES> m_laneLimits;
+        std::atomic_bool m_hasLaneLimits;
+        /// Events waiting for dispatch per lane - carried over between frames
+        std::array<PendingEvents, NUM_EVENT_LANES> m_lanes;
+        std::array<EventLaneStats, NUM_EVENT_LANES> m_laneStats;
+        /// Per call budget for processEvents (zero - unlimited)
+        std::atomic<unsigned int> m_budgetEvents;
+        std::atomic<double> m_budgetTime;
+        /// Shared pool for parallel handlers (not running by default)
+        util::WorkerPool m_workerPool;
+        /// Optional recorder of thrown events and timer firings (not owned)
+        std::atomic<EventRecorder *> m_pRecorder;
+        /// Metrics per event type (written under the event binds lock)
+        EventMetricsTable m_metrics;
+        std::atomic_bool m_metricsEnabled;
+        /// Names of custom event types registered at runtime
+        EventTypeRegistry m_eventTypes;
+        /// Pool with timers - these are one shot timeouts and intervals, keeps the
+        /// min-heap of deadlines, only the expired top entries are touched per frame
+        TimerPool m_timers;
+        /// Timers that expired in the current processTimers() pass (reused between calls)
+        std::vector<TimerEntryInfo *> m_dueTimers;
+        /// Timers passed over by the timer thread (Handoff mode), guarded by timers lock
+        std::vector<TimerEntryInfo *> m_handoffTimers;
+        /// Optional dedicated timer thread (see startTimerThread)
+        std::thread m_timerThread;
+        std::atomic_bool m_timerThreadRunning;
+        TimerThreadMode m_timerThreadMode;
+        std::function<void(void)> m_timerNotify;
+        /// Guarded by the timer thread mutex
+        bool m_timerThreadStop;
+        bool m_timerThreadWake;
+        std::mutex m_mutexTimerThread;
+        std::condition_variable m_timerThreadCondition;
         ///
         std::vector<uint32_t> m_markedTimeouts;
-        ///
-        EventsPtrVec m_eventStructs;
-        ///
-        EventsPtrVec m_eventStructsFreeSlots;
-        ///
-        mutable std::mutex m_mutexEventsQueue;
-        ///
+        /// Pool of event structures (thread safe)
+        EventStructPool m_eventStructs;
+        /// Callbacks removed from the binds, waiting for the dispatches of their epoch
+        std::vector<RetiredCallback> m_retiredCallbacks;
+        /// Dispatch epoch - moved on (under the event binds lock) by reclaimCallbacks
+        std::atomic<uint64_t> m_dispatchEpoch;
+        /// Number of dispatches (executeEvent) in progress per epoch parity - only two
+        /// epochs can have dispatches in progress at a time
+        std::array<std::atomic<unsigned int>, 2> m_activeDispatches;
+        std::atomic_bool m_hasRetiredCallbacks;
+        /// Protects writers of event binds - dispatch does not lock
         mutable std::mutex m_mutexEventBinds;
         ///
         mutable std::mutex m_mutexTimers;
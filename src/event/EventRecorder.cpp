@@ -0,0 +1,396 @@
+#include <event/EventRecorder.hpp>
+#include <event/EventManager.hpp>
+#include <util/Timesys.hpp>
+
+namespace event
+{
+    namespace record
+    {
+        template <typename ValueType>
+        inline void append(EventRecorder::Buffer &buffer, const ValueType &value)
+        {
+            const auto offset = buffer.size();
+            buffer.resize(offset + sizeof(ValueType));
+            std::memcpy(&buffer[offset], &value, sizeof(ValueType));
+        }
+
+        inline void append(EventRecorder::Buffer &buffer, const void *data, std::size_t length)
+        {
+            const auto offset = buffer.size();
+            buffer.resize(offset + length);
+            if (length)
+                std::memcpy(&buffer[offset], data, length);
+        }
+
+        /// Offset of the plain data inside of EventCombined (the union with all events)
+        inline std::size_t payloadOffset(const EventCombined *pStruct)
+        {
+            return static_cast<std::size_t>(reinterpret_cast<const uint8_t *>(&pStruct->eventType) - reinterpret_cast<const uint8_t *>(pStruct));
+        }
+
+        template <typename ValueType>
+        inline util::WrappedValue makePrimitive(uint64_t raw)
+        {
+            ValueType value;
+            std::memcpy(&value, &raw, sizeof(ValueType));
+            util::WrappedValue wrapped;
+            wrapped.set(value);
+            return wrapped;
+        }
+    } //> namespace record
+} //> namespace event
+
+event::EventRecorder::EventRecorder() : m_buffer(), m_file(), m_startTs(0), m_count(0), m_recording(false), m_mutex() {}
+//>---------------------------------------------------------------------------------------
+
+event::EventRecorder::~EventRecorder()
+{
+    stop();
+}
+//>---------------------------------------------------------------------------------------
+
+void event::EventRecorder::start(void)
+{
+    stop();
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_buffer.clear();
+    m_count = 0;
+    m_startTs = timesys::ticks();
+    writeHeader();
+    m_recording.store(true, std::memory_order_release);
+} //> start(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventRecorder::start(std::string_view filePath)
+{
+    stop();
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_file.setMode(util::RegularFile::Mode::WRITE | util::RegularFile::Mode::BINARY);
+    if (!m_file.open(filePath))
+        return false;
+    m_buffer.clear();
+    m_count = 0;
+    m_startTs = timesys::ticks();
+    writeHeader();
+    m_recording.store(true, std::memory_order_release);
+    return true;
+} //> start(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventRecorder::stop(void)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_recording.store(false, std::memory_order_release);
+    if (m_file.isOpen())
+    {
+        flush();
+        m_file.close();
+    }
+} //> stop(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventRecorder::writeHeader(void)
+{
+    record::append(m_buffer, record::MAGIC);
+    record::append(m_buffer, record::VERSION);
+} //> writeHeader(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventRecorder::flush(void)
+{
+    if (!m_file.isOpen() || m_buffer.empty())
+        return;
+    m_file.write(m_buffer.data(), 1, static_cast<unsigned int>(m_buffer.size()));
+    m_file.flush();
+    m_buffer.clear(); // capacity is retained
+} //> flush(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventRecorder::recordEvent(const ThrownEvent &thrownEvent, const EventStructPool &structs)
+{
+    if (!isRecording())
+        return;
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (!isRecording())
+        return;
+    record::append(m_buffer, static_cast<uint8_t>(record::Kind::Event));
+    record::append(m_buffer, static_cast<int64_t>(timesys::ticks() - m_startTs));
+    record::append(m_buffer, static_cast<uint32_t>(thrownEvent.eventCode));
+    auto &args = const_cast<EventArgs &>(thrownEvent.args);
+    record::append(m_buffer, static_cast<uint16_t>(args.size()));
+    for (std::size_t idx = 0; idx < args.size(); idx++)
+        writeValue(args[idx], structs);
+    m_count++;
+    if (m_buffer.size() >= FLUSH_THRESHOLD)
+        flush();
+} //> recordEvent(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventRecorder::recordTimer(uint32_t timerId)
+{
+    if (!isRecording())
+        return;
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (!isRecording())
+        return;
+    record::append(m_buffer, static_cast<uint8_t>(record::Kind::Timer));
+    record::append(m_buffer, static_cast<int64_t>(timesys::ticks() - m_startTs));
+    record::append(m_buffer, timerId);
+    record::append(m_buffer, static_cast<uint16_t>(0));
+    m_count++;
+    if (m_buffer.size() >= FLUSH_THRESHOLD)
+        flush();
+} //> recordTimer(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventRecorder::writeValue(const util::WrappedValue *pValue, const EventStructPool &structs)
+{
+    const auto type = pValue ? pValue->getType() : util::WrappedValue::INVALID;
+    record::append(m_buffer, static_cast<uint8_t>(type));
+    const std::string empty;
+    const auto &typeName = pValue ? pValue->getTypeName() : empty;
+    record::append(m_buffer, static_cast<uint16_t>(typeName.size()));
+    record::append(m_buffer, typeName.data(), typeName.size());
+    if (!pValue || type == util::WrappedValue::INVALID)
+        return;
+    if (type == util::WrappedValue::STRING)
+    {
+        const auto &value = pValue->get<std::string>();
+        record::append(m_buffer, static_cast<uint32_t>(value.size()));
+        record::append(m_buffer, value.data(), value.size());
+    }
+    else if (type == util::WrappedValue::EXTERNAL)
+    {
+        auto pStruct = reinterpret_cast<const EventCombined *>(pValue->getExternalPointer<void>());
+        if (!pStruct || !structs.owns(pStruct))
+        {
+            record::append(m_buffer, static_cast<uint32_t>(Type::Invalid));
+            return;
+        }
+        const auto offset = record::payloadOffset(pStruct);
+        record::append(m_buffer, static_cast<uint32_t>(pStruct->eventType));
+        record::append(m_buffer, reinterpret_cast<const uint8_t *>(pStruct) + offset, sizeof(EventCombined) - offset);
+    }
+    else
+    {
+        record::append(m_buffer, pValue->get<uint64_t>()); // packed value
+    }
+} //> writeValue(...)
+//>---------------------------------------------------------------------------------------
+
+event::EventReplayer::EventReplayer() : m_data(),
+                                        m_position(0),
+                                        m_speed(1.0),
+                                        m_startTs(0.0),
+                                        m_events(0),
+                                        m_timers(0),
+                                        m_timerHandler() {}
+//>---------------------------------------------------------------------------------------
+
+event::EventReplayer::~EventReplayer()
+{
+    m_data.clear();
+}
+//>---------------------------------------------------------------------------------------
+
+bool event::EventReplayer::load(std::string_view filePath)
+{
+    util::RegularFile file;
+    file.setMode(util::RegularFile::Mode::READ | util::RegularFile::Mode::BINARY);
+    if (!file.open(filePath))
+        return false;
+    Buffer data(static_cast<std::size_t>(file.getSize()));
+    const auto length = data.empty() ? 0 : file.read(data.data(), 1, static_cast<unsigned int>(data.size()));
+    file.close();
+    if (length < 0)
+        return false;
+    data.resize(static_cast<std::size_t>(length));
+    return load(data);
+} //> load(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventReplayer::load(const Buffer &data)
+{
+    m_data = data;
+    m_position = 0;
+    m_events = 0;
+    m_timers = 0;
+    uint32_t magic = 0, version = 0;
+    if (!readRaw(magic) || !readRaw(version) || magic != record::MAGIC || version != record::VERSION)
+    {
+        m_data.clear();
+        m_position = 0;
+        return false;
+    }
+    return true;
+} //> load(...)
+//>---------------------------------------------------------------------------------------
+
+void event::EventReplayer::start(double speed)
+{
+    m_speed = speed;
+    m_startTs = timesys::ms();
+} //> start(...)
+//>---------------------------------------------------------------------------------------
+
+event::EventReplayer::size_type event::EventReplayer::update(EventManager &eventManager)
+{
+    size_type count = 0;
+    const auto elapsed = timesys::ms() - m_startTs;
+    while (!isFinished())
+    {
+        const auto recordStart = m_position;
+        uint8_t kind = 0;
+        int64_t timeStamp = 0;
+        uint32_t code = 0;
+        uint16_t argc = 0;
+        if (!readRaw(kind) || !readRaw(timeStamp) || !readRaw(code) || !readRaw(argc))
+        {
+            m_position = m_data.size(); // truncated log
+            break;
+        }
+        if (m_speed > 0.0 && static_cast<double>(timeStamp) / m_speed > elapsed)
+        {
+            m_position = recordStart; // not yet
+            break;
+        }
+        if (static_cast<record::Kind>(kind) == record::Kind::Timer)
+        {
+            m_timers++;
+            if (m_timerHandler)
+                m_timerHandler(code, timeStamp);
+        }
+        else
+        {
+            ThrownEvent thrownEvent(static_cast<Type>(code));
+            bool status = true;
+            for (uint16_t idx = 0; idx < argc && status; idx++)
+                status = readValue(eventManager, thrownEvent);
+            if (!status)
+            {
+                eventManager.discardEvents(&thrownEvent, 1);
+                m_position = m_data.size();
+                break;
+            }
+            eventManager.throwEvent(std::move(thrownEvent));
+            m_events++;
+        }
+        count++;
+    } //# for each due record
+    return count;
+} //> update(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventReplayer::readBytes(std::string &output, size_type length)
+{
+    if (m_position + length > m_data.size())
+        return false;
+    output.assign(reinterpret_cast<const char *>(m_data.data() + m_position), length);
+    m_position += length;
+    return true;
+} //> readBytes(...)
+//>---------------------------------------------------------------------------------------
+
+bool event::EventReplayer::readValue(EventManager &eventManager, ThrownEvent &output)
+{
+    uint8_t type = 0;
+    uint16_t nameLength = 0;
+    std::string typeName;
+    if (!readRaw(type) || !readRaw(nameLength) || !readBytes(typeName, nameLength))
+        return false;
+    switch (static_cast<util::WrappedValue::Type>(type))
+    {
+    case util::WrappedValue::INVALID:
+        output.args.push(util::WrappedValue());
+        return true;
+    case util::WrappedValue::STRING:
+    {
+        uint32_t length = 0;
+        std::string value;
+        if (!readRaw(length) || !readBytes(value, length))
+            return false;
+        output.args.push(util::WrappedValue(value, typeName.c_str()));
+        return true;
+    }
+    case util::WrappedValue::EXTERNAL:
+    {
+        uint32_t structType = 0;
+        if (!readRaw(structType))
+            return false;
+        if (static_cast<Type>(structType) == Type::Invalid)
+        {
+            // pointer that can't be restored
+            output.args.push(util::WrappedValue(typeName.c_str(), nullptr, 0, 0));
+            return true;
+        }
+        auto pStruct = reinterpret_cast<EventCombined *>(eventManager.requestEventStruct(static_cast<Type>(structType)));
+        const auto offset = record::payloadOffset(pStruct);
+        const auto length = sizeof(EventCombined) - offset;
+        if (m_position + length > m_data.size())
+        {
+            eventManager.releaseEventStruct(reinterpret_cast<EventBase *>(pStruct));
+            return false;
+        }
+        std::memcpy(reinterpret_cast<uint8_t *>(pStruct) + offset, &m_data[m_position], length);
+        m_position += length;
+        pStruct->identifier = EventCombined::autoid(); // fresh identity, recorded payload
+        output.args.push(util::WrappedValue(typeName.c_str(), pStruct, 0, 0));
+        return true;
+    }
+    default:
+        break;
+    }
+    uint64_t raw = 0;
+    if (!readRaw(raw))
+        return false;
+    switch (static_cast<util::WrappedValue::Type>(type))
+    {
+    case util::WrappedValue::CHAR:
+        output.args.push(record::makePrimitive<char>(raw));
+        break;
+    case util::WrappedValue::SIGNED_CHAR:
+        output.args.push(record::makePrimitive<signed char>(raw));
+        break;
+    case util::WrappedValue::UNSIGNED_CHAR:
+        output.args.push(record::makePrimitive<unsigned char>(raw));
+        break;
+    case util::WrappedValue::SHORT:
+    case util::WrappedValue::SIGNED_SHORT:
+        output.args.push(record::makePrimitive<short>(raw));
+        break;
+    case util::WrappedValue::UNSIGNED_SHORT:
+        output.args.push(record::makePrimitive<unsigned short>(raw));
+        break;
+    case util::WrappedValue::INT:
+        output.args.push(record::makePrimitive<int>(raw));
+        break;
+    case util::WrappedValue::UNSIGNED_INT:
+        output.args.push(record::makePrimitive<unsigned int>(raw));
+        break;
+    case util::WrappedValue::LONG:
+        output.args.push(record::makePrimitive<long>(raw));
+        break;
+    case util::WrappedValue::UNSIGNED_LONG:
+        output.args.push(record::makePrimitive<unsigned long>(raw));
+        break;
+    case util::WrappedValue::LONG_LONG:
+        output.args.push(record::makePrimitive<long long>(raw));
+        break;
+    case util::WrappedValue::UNSIGNED_LONG_LONG:
+        output.args.push(record::makePrimitive<unsigned long long>(raw));
+        break;
+    case util::WrappedValue::FLOAT:
+        output.args.push(record::makePrimitive<float>(raw));
+        break;
+    case util::WrappedValue::DOUBLE:
+        output.args.push(record::makePrimitive<double>(raw));
+        break;
+    case util::WrappedValue::BOOL:
+        output.args.push(record::makePrimitive<bool>(raw));
+        break;
+    default:
+        return false; // unknown value type
+    }
+    return true;
+} //> readValue(...)
+//>---------------------------------------------------------------------------------------
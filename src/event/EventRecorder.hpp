@@ -0,0 +1,181 @@
+#pragma once
+#ifndef FG_INC_EVENT_RECORDER
+#define FG_INC_EVENT_RECORDER
+
+#include <event/EventHelper.hpp>
+#include <util/RegularFile.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace event
+{
+    class EventManager;
+
+    /**
+     * @brief Binary event log. Every record holds the timestamp (milliseconds since the
+     * start of the recording), the kind, the event code (or the timer id) and the
+     * serialized arguments. Event structures from the manager's pool are stored as the
+     * raw payload of EventCombined, other external pointers can't be restored and are
+     * stored as null. The log is tied to the build that wrote it (structure layout).
+     *
+     * Layout: header {magic, version} followed by records
+     *  record: kind (u8), timestamp (i64), code (u32), argc (u16), args...
+     *  arg:    type (u8), type name (u16 length + bytes), value
+     *  value:  primitives - packed 8 bytes, strings - u32 length + bytes,
+     *          external - event type (u32, zero if not an event structure) + payload
+     */
+    namespace record
+    {
+        inline constexpr uint32_t MAGIC = 0x56454746; // 'FGEV'
+        inline constexpr uint32_t VERSION = 1;
+
+        enum class Kind : uint8_t
+        {
+            Invalid = 0,
+            /// Thrown event (recorded in throwEvent)
+            Event = 1,
+            /// Timer firing (recorded in processTimers)
+            Timer = 2
+        };
+    } //> namespace record
+
+    class EventRecorder
+    {
+    public:
+        using self_type = EventRecorder;
+        using size_type = std::size_t;
+        using Buffer = std::vector<uint8_t>;
+
+        /// Buffered data is written to the file when it grows over this size
+        static const size_type FLUSH_THRESHOLD = 64 * 1024;
+
+    public:
+        EventRecorder();
+        ~EventRecorder();
+
+        EventRecorder(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+    public:
+        /**
+         * Start recording into memory (see data()), previous data is discarded
+         */
+        void start(void);
+        /**
+         * Start recording into the file - data is flushed periodically and on stop()
+         */
+        bool start(std::string_view filePath);
+        void stop(void);
+
+        inline bool isRecording(void) const noexcept { return m_recording.load(std::memory_order_acquire); }
+
+        /// Number of records written since start
+        inline size_type count(void) const noexcept { return m_count; }
+
+        /**
+         * Recorded data (memory recording only - file recording keeps only the tail
+         * that was not flushed yet). Not synchronized, call after stop().
+         */
+        inline Buffer const &data(void) const noexcept { return m_buffer; }
+
+        /**
+         * Append the event (thread safe). Arguments are only read.
+         */
+        void recordEvent(const ThrownEvent &thrownEvent, const EventStructPool &structs);
+        /**
+         * Append the timer firing (thread safe)
+         */
+        void recordTimer(uint32_t timerId);
+
+    protected:
+        void writeHeader(void);
+        void writeValue(const util::WrappedValue *pValue, const EventStructPool &structs);
+        void flush(void);
+
+    private:
+        Buffer m_buffer;
+        util::RegularFile m_file;
+        int64_t m_startTs;
+        size_type m_count;
+        std::atomic_bool m_recording;
+        std::mutex m_mutex;
+    }; //# class EventRecorder
+    //#-----------------------------------------------------------------------------------
+
+    /**
+     * @brief Feeds the recorded log back into the event manager - at the recorded pace,
+     * accelerated, or all at once. Call update() every frame (before processEvents).
+     */
+    class EventReplayer
+    {
+    public:
+        using self_type = EventReplayer;
+        using size_type = std::size_t;
+        using Buffer = EventRecorder::Buffer;
+        using TimerHandler = std::function<void(uint32_t timerId, int64_t timeStamp)>;
+
+    public:
+        EventReplayer();
+        ~EventReplayer();
+
+        EventReplayer(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+    public:
+        bool load(std::string_view filePath);
+        bool load(const Buffer &data);
+
+        /**
+         * Start feeding the events.
+         * @param speed Time scale (2.0 - twice as fast), zero or less - no delays
+         */
+        void start(double speed = 1.0);
+
+        /**
+         * Throw all events that are due at this point.
+         * @return Number of records processed
+         */
+        size_type update(EventManager &eventManager);
+
+        inline bool isFinished(void) const noexcept { return m_position >= m_data.size(); }
+
+        /// Called for recorded timer firings (timers are not recreated)
+        inline void setTimerHandler(const TimerHandler &handler) { m_timerHandler = handler; }
+
+        inline size_type eventsCount(void) const noexcept { return m_events; }
+
+        inline size_type timersCount(void) const noexcept { return m_timers; }
+
+    protected:
+        bool readValue(EventManager &eventManager, ThrownEvent &output);
+
+        template <typename ValueType>
+        bool readRaw(ValueType &value)
+        {
+            if (m_position + sizeof(ValueType) > m_data.size())
+                return false;
+            std::memcpy(&value, &m_data[m_position], sizeof(ValueType));
+            m_position += sizeof(ValueType);
+            return true;
+        }
+
+        bool readBytes(std::string &output, size_type length);
+
+    private:
+        Buffer m_data;
+        size_type m_position;
+        double m_speed;
+        double m_startTs;
+        size_type m_events;
+        size_type m_timers;
+        TimerHandler m_timerHandler;
+    }; //# class EventReplayer
+} //> namespace event
+
+#endif //> FG_INC_EVENT_RECORDER
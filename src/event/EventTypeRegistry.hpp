@@ -0,0 +1,115 @@
+#pragma once
+#ifndef FG_INC_EVENT_TYPE_REGISTRY
+#define FG_INC_EVENT_TYPE_REGISTRY
+
+#include <event/DispatchTable.hpp>
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace event
+{
+    /**
+     * @brief Names of custom event types registered at runtime mapped to dense type codes.
+     * Codes are handed out sequentially from the first dispatch table chunk past the
+     * standard range, so every registered type gets its own dispatch slot (callbacks,
+     * filters, metrics) and is routed exactly like a built-in type - no switching on a
+     * payload field in shared EventCustom handlers.
+     *
+     * Codes are never reused - registering the same name again returns the same code.
+     * All functions are thread safe.
+     */
+    class EventTypeRegistry
+    {
+    public:
+        using self_type = EventTypeRegistry;
+        using size_type = std::size_t;
+
+        /// First code given to a registered type (start of the chunk after the standard range)
+        static const size_type FIRST_CODE = (DispatchTable<int>::STANDARD_CODES + DispatchTable<int>::CHUNK_SIZE - 1) /
+                                            DispatchTable<int>::CHUNK_SIZE * DispatchTable<int>::CHUNK_SIZE;
+        /// Registered codes stay below the limit of directly indexed codes
+        static const size_type MAX_TYPES = DispatchTable<int>::MAX_DENSE_CODES - FIRST_CODE;
+
+    public:
+        EventTypeRegistry() : m_mutex(), m_codes(), m_names() {}
+
+        EventTypeRegistry(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+    public:
+        static inline bool isRegisteredCode(Type eventCode) noexcept
+        {
+            const auto code = static_cast<size_type>(eventCode);
+            return code >= FIRST_CODE && code < FIRST_CODE + MAX_TYPES;
+        }
+
+        /**
+         * @return Code of the type with the given name, registers it if needed.
+         *         Invalid if the name is empty or the registry is full.
+         */
+        Type add(std::string_view name)
+        {
+            if (name.empty())
+                return Type::Invalid;
+            std::string key(name);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto found = m_codes.find(key);
+            if (found != m_codes.end())
+                return found->second;
+            if (m_names.size() >= MAX_TYPES)
+                return Type::Invalid;
+            const auto eventCode = static_cast<Type>(FIRST_CODE + m_names.size());
+            m_names.push_back(key);
+            m_codes.emplace(std::move(key), eventCode);
+            return eventCode;
+        }
+
+        /**
+         * @return Code of the registered type or Invalid
+         */
+        Type find(std::string_view name) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto found = m_codes.find(std::string(name));
+            return found == m_codes.end() ? Type::Invalid : found->second;
+        }
+
+        /**
+         * @return Name of the registered type, empty for unknown codes
+         */
+        std::string name(Type eventCode) const
+        {
+            if (!isRegisteredCode(eventCode))
+                return std::string();
+            const auto index = static_cast<size_type>(eventCode) - FIRST_CODE;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return index < m_names.size() ? m_names[index] : std::string();
+        }
+
+        bool contains(Type eventCode) const
+        {
+            if (!isRegisteredCode(eventCode))
+                return false;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return static_cast<size_type>(eventCode) - FIRST_CODE < m_names.size();
+        }
+
+        size_type size(void) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_names.size();
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, Type> m_codes;
+        /// Names indexed with (code - FIRST_CODE)
+        std::vector<std::string> m_names;
+    }; //# class EventTypeRegistry
+} //> namespace event
+
+#endif //> FG_INC_EVENT_TYPE_REGISTRY
@@ -0,0 +1,208 @@
+#pragma once
+#ifndef FG_INC_EVENT_SIGNAL
+#define FG_INC_EVENT_SIGNAL
+
+#include <event/EventManager.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace event
+{
+    /**
+     * @brief Statically typed event signal, e.g. Signal<EventMouse *>. Native handlers
+     * are invoked directly through template thunks - the arguments are passed as they
+     * are, nothing is wrapped and nothing is allocated on emit.
+     *
+     * The signal is bound to an event type of the manager, so it interoperates with the
+     * dynamic path (script subscribers):
+     *  - emit() forwards to the callbacks bound to the event type (addCallback), the
+     *    arguments are wrapped in place only when there is any such callback
+     *  - attach() registers a bridge callback, so events thrown or executed through the
+     *    manager reach the typed handlers as well (the argument types must match)
+     *
+     * Connecting and disconnecting is thread safe (copy on write list of slots).
+     */
+    template <typename... Args>
+    class Signal
+    {
+    public:
+        using self_type = Signal<Args...>;
+        using ErasedFunction = void (*)(void);
+        using Thunk = void (*)(void *object, ErasedFunction function, Args... args);
+
+        struct Slot
+        {
+            Thunk thunk;
+            void *object;
+            ErasedFunction function;
+            uint32_t id;
+        }; //# struct Slot
+
+        using SlotsVec = std::vector<Slot>;
+        using SlotsList = std::shared_ptr<const SlotsVec>;
+
+    public:
+        Signal(EventManager *pManager = nullptr, Type eventCode = Type::Invalid)
+            : m_pManager(pManager), m_eventCode(eventCode), m_slots(), m_nextId(0), m_pBridge(nullptr), m_mutex() {}
+
+        ~Signal() { detach(); }
+
+        Signal(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+    public:
+        inline Type getEventType(void) const noexcept { return m_eventCode; }
+
+        inline bool isAttached(void) const noexcept { return m_pBridge != nullptr; }
+
+        /**
+         * Connect a free function (the return value is ignored)
+         * @return Connection identifier
+         */
+        template <typename ReturnType>
+        uint32_t connect(ReturnType (*function)(Args...))
+        {
+            if (!function)
+                return 0;
+            return insert(&self_type::functionThunk<ReturnType>, nullptr, reinterpret_cast<ErasedFunction>(function));
+        }
+
+        /**
+         * Connect a method: signal.connect<&UserClass::method>(pObject)
+         * @return Connection identifier
+         */
+        template <auto Method, typename UserClass>
+        uint32_t connect(UserClass *pObject)
+        {
+            if (!pObject)
+                return 0;
+            return insert(&self_type::methodThunk<Method, UserClass>, pObject, nullptr);
+        }
+
+        bool disconnect(uint32_t id)
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            auto pSlots = std::atomic_load(&m_slots);
+            if (!pSlots)
+                return false;
+            auto slots = std::make_shared<SlotsVec>(*pSlots);
+            for (auto it = slots->begin(); it != slots->end(); it++)
+            {
+                if (it->id != id)
+                    continue;
+                slots->erase(it);
+                std::atomic_store(&m_slots, SlotsList(std::move(slots)));
+                return true;
+            }
+            return false;
+        }
+
+        void disconnectAll(void)
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            std::atomic_store(&m_slots, SlotsList());
+        }
+
+        inline std::size_t size(void) const
+        {
+            auto pSlots = std::atomic_load(&m_slots);
+            return pSlots ? pSlots->size() : 0;
+        }
+
+        /**
+         * Call the typed handlers, then the dynamic callbacks bound to the event type
+         * @return Number of handlers called
+         */
+        unsigned int emit(Args... args) const
+        {
+            unsigned int count = invoke(args...);
+            if (!m_pManager)
+                return count;
+            const auto bridged = m_pBridge ? 1u : 0u;
+            if (m_pManager->getCallbacksCount(m_eventCode) <= bridged)
+                return count;
+            EventArgs wrapped;
+            (wrapped.push(util::WrappedValue::wrapInPlace(args)), ...);
+            util::ArgsView view(wrapped);
+            // the bridge is skipped - the typed handlers were already called
+            count += m_pManager->forwardEvent(m_eventCode, view.get(), m_pBridge);
+            return count;
+        }
+
+        inline unsigned int operator()(Args... args) const { return emit(args...); }
+
+        /**
+         * Register the bridge callback - events dispatched by the manager for this event
+         * type are passed to the typed handlers (slower path, arguments are unwrapped)
+         */
+        bool attach(void)
+        {
+            if (!m_pManager || m_pBridge || m_eventCode == Type::Invalid)
+                return false;
+            m_pBridge = m_pManager->addCallback(m_eventCode, &self_type::forward, this);
+            return m_pBridge != nullptr;
+        }
+
+        void detach(void)
+        {
+            if (!m_pManager || !m_pBridge)
+                return;
+            m_pManager->deleteCallback(m_eventCode, m_pBridge);
+            m_pBridge = nullptr;
+        }
+
+    protected:
+        uint32_t insert(Thunk thunk, void *object, ErasedFunction function)
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            auto pSlots = std::atomic_load(&m_slots);
+            auto slots = pSlots ? std::make_shared<SlotsVec>(*pSlots) : std::make_shared<SlotsVec>();
+            const auto id = ++m_nextId;
+            slots->push_back(Slot{thunk, object, function, id});
+            std::atomic_store(&m_slots, SlotsList(std::move(slots)));
+            return id;
+        }
+
+        unsigned int invoke(Args... args) const
+        {
+            auto pSlots = std::atomic_load(&m_slots);
+            if (!pSlots)
+                return 0;
+            for (auto &slot : *pSlots)
+                slot.thunk(slot.object, slot.function, args...);
+            return static_cast<unsigned int>(pSlots->size());
+        }
+
+        /// Target of the bridge callback (dynamic path)
+        bool forward(Args... args)
+        {
+            invoke(args...);
+            return true;
+        }
+
+        template <typename ReturnType>
+        static void functionThunk(void *object, ErasedFunction function, Args... args)
+        {
+            reinterpret_cast<ReturnType (*)(Args...)>(function)(args...);
+        }
+
+        template <auto Method, typename UserClass>
+        static void methodThunk(void *object, ErasedFunction function, Args... args)
+        {
+            (static_cast<UserClass *>(object)->*Method)(args...);
+        }
+
+    private:
+        EventManager *m_pManager;
+        Type m_eventCode;
+        SlotsList m_slots;
+        uint32_t m_nextId;
+        util::Callback *m_pBridge;
+        std::mutex m_mutex;
+    }; //# class Signal
+} //> namespace event
+
+#endif //> FG_INC_EVENT_SIGNAL
@@ -4,40 +4,63 @@
 
 #include <event/EventDefinitions.hpp>
 #include <util/Bindings.hpp>
+#include <util/InlineArgs.hpp>
+
+#include <utility>
 
 namespace event
 {
+    /// Argument list for thrown events and timers - first three values are stored
+    /// inline, so throwing a typical event does not allocate per argument
+    using EventArgs = util::InlineArgs<3>;
+
     /**
-     * @brief Information about thrown event, so this includes event code, pointer to vector
-     * holding input arguments (wrapped values / universal) - owned by event manager.
+     * @brief Information about thrown event, so this includes event code, input arguments
+     * (wrapped values / universal) - owned by event manager.
      */
     struct ThrownEvent
     {
         Type eventCode;
-        util::WrappedArgs args;
+        EventArgs args;
+        /// Marker only - the actual event waits in the coalescing slot for its type
+        bool coalesced;
+        /// Time of enqueue in nanoseconds (steady clock), zero if metrics and thread staging
+        /// are disabled (staged events are merged by this value)
+        int64_t queuedNs;
+
+        ThrownEvent() : eventCode(Type::Invalid), args(), coalesced(false), queuedNs(0) {}
 
-        ThrownEvent() : eventCode(Type::Invalid), args() {}
+        explicit ThrownEvent(Type _eventCode) : eventCode(_eventCode), args(), coalesced(false), queuedNs(0) {}
 
         ThrownEvent(Type _eventCode, util::WrappedArgs &_args) : eventCode(_eventCode),
-                                                                 args(std::move(_args)) {}
+                                                                 args(std::move(_args)),
+                                                                 coalesced(false),
+                                                                 queuedNs(0) {}
 
         ThrownEvent(const ThrownEvent &other) = delete;
         ThrownEvent &operator=(const ThrownEvent &other) = delete;
 
         ThrownEvent(ThrownEvent &&other) noexcept : eventCode(std::exchange(other.eventCode, Type::Invalid)),
-                                                    args(std::move(other.args)) {}
+                                                    args(std::move(other.args)),
+                                                    coalesced(std::exchange(other.coalesced, false)),
+                                                    queuedNs(std::exchange(other.queuedNs, 0)) {}
 
         ThrownEvent &operator=(ThrownEvent &&other) noexcept
         {
             eventCode = other.eventCode;
             args = std::move(other.args);
+            coalesced = other.coalesced;
+            queuedNs = other.queuedNs;
             other.eventCode = Type::Invalid;
+            other.coalesced = false;
+            other.queuedNs = 0;
+            return *this;
         }
 
         ~ThrownEvent()
         {
             eventCode = Type::Invalid;
-            util::reset_arguments(args);
+            args.reset();
         }
     }; //# struct ThrownEvent
 
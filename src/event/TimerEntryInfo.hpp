@@ -9,6 +9,31 @@ namespace event
 {
     struct TimerHelper;
 
+    /**
+     * How the dedicated timer thread delivers expired timers
+     */
+    enum class TimerThreadMode
+    {
+        /// Callbacks are executed directly on the timer thread
+        Fire,
+        /// Expired timers are passed to the next processTimers() call (owning thread)
+        Handoff
+    };
+
+    /**
+     * How the next deadline of an interval is computed
+     */
+    enum class IntervalMode : uint8_t
+    {
+        /// Measured from the end of the last callback (drifts by the processing latency)
+        FixedDelay,
+        /// Fixed rate on the original schedule - missed periods are fired one after
+        /// another until the timer is back on schedule
+        CatchUp,
+        /// Fixed rate on the original schedule - missed periods are dropped
+        Skip
+    };
+
     using WrappedArgs = ::util::WrappedArgs;
 
     struct TimerEntryInfo
@@ -31,27 +56,40 @@ namespace event
 
     public:
         int timeout;
+        /// Tolerance in milliseconds - the timer can fire up to this much later than the
+        /// deadline, so that timers with overlapping windows are fired in one batch
+        int slack;
         int repeats;
+        /// Start of the current period (deadline is currentTs + timeout)
         int64_t currentTs;
+        /// Number of periods that were skipped or fired at least a full period late
+        uint64_t missedPeriods;
+        IntervalMode mode;
         bool triggered;
-        WrappedArgs args;
+        /// Set while the callback is being executed outside of the timers lock
+        bool firing;
+        EventArgs args;
 
     protected:
         std::unique_ptr<util::Callback> callback;
 
     public:
-        TimerEntryInfo() : type(INTERVAL), id(autoid()), timeout(0), repeats(0), currentTs(timesys::ticks()), triggered(false), args(), callback() {}
+        TimerEntryInfo() : type(INTERVAL), id(autoid()), timeout(0), slack(0), repeats(0), currentTs(timesys::ticks()), missedPeriods(0), mode(IntervalMode::FixedDelay), triggered(false), firing(false), args(), callback() {}
         TimerEntryInfo(uint32_t _id, int _repeats, int _timeout, util::Callback *_pCallback)
-            : type(INTERVAL), id(!_id ? TimerEntryInfo::autoid() : _id), timeout(_timeout), repeats(_repeats), currentTs(timesys::ticks()), triggered(false), args(), callback(_pCallback) {}
+            : type(INTERVAL), id(!_id ? TimerEntryInfo::autoid() : _id), timeout(_timeout), slack(0), repeats(_repeats), currentTs(timesys::ticks()), missedPeriods(0), mode(IntervalMode::FixedDelay), triggered(false), firing(false), args(), callback(_pCallback) {}
 
         ~TimerEntryInfo()
         {
-            util::reset_arguments(args);
+            args.reset();
             id = 0;
             timeout = 0;
+            slack = 0;
             repeats = 0;
             currentTs = 0;
+            missedPeriods = 0;
+            mode = IntervalMode::FixedDelay;
             triggered = false;
+            firing = false;
         }
 
         TimerEntryInfo(const TimerEntryInfo &other) = delete;
@@ -62,45 +100,77 @@ namespace event
             id = other.id;
             type = other.type;
             timeout = other.timeout;
+            slack = other.slack;
             repeats = other.repeats;
             currentTs = other.currentTs;
+            missedPeriods = other.missedPeriods;
+            mode = other.mode;
             triggered = other.triggered;
+            firing = other.firing;
             other.id = 0;
             other.timeout = 0;
+            other.slack = 0;
             other.repeats = 0;
             other.currentTs = 0LL;
+            other.missedPeriods = 0;
             other.triggered = false;
+            other.firing = false;
         }
 
         TimerEntryInfo &operator=(TimerEntryInfo &&other) noexcept
         {
-            util::reset_arguments(args); // cleanup previous value
+            args.reset(); // cleanup previous value
             callback = std::move(other.callback);
             args = std::move(other.args);
             id = other.id;
             type = other.type;
             timeout = other.timeout;
+            slack = other.slack;
             repeats = other.repeats;
             currentTs = other.currentTs;
+            missedPeriods = other.missedPeriods;
+            mode = other.mode;
             triggered = other.triggered;
+            firing = other.firing;
             other.id = 0;
             other.timeout = 0;
+            other.slack = 0;
             other.repeats = 0;
             other.currentTs = 0LL;
+            other.missedPeriods = 0;
             other.triggered = false;
+            other.firing = false;
+            return *this;
+        }
+
+        /**
+         * Release the callback and arguments, the identifier is cleared
+         */
+        void reset(void)
+        {
+            args.reset();
+            callback.reset();
+            id = 0;
+            timeout = 0;
+            slack = 0;
+            repeats = 0;
+            currentTs = 0;
+            missedPeriods = 0;
+            mode = IntervalMode::FixedDelay;
+            triggered = false;
+            firing = false;
         }
 
         TimerEntryInfo &setArgs(const WrappedArgs &_args)
         {
-            util::reset_arguments(this->args); // cleanup previous value
-            this->args = _args;
+            this->args.assign(_args); // deep copy, previous value is released
             return *this;
         }
 
         TimerEntryInfo &setArgs(WrappedArgs &&_args)
         {
-            util::reset_arguments(this->args); // cleanup previous value
-            this->args = std::move(_args);
+            this->args.reset(); // cleanup previous value
+            this->args.adopt(std::move(_args));
             return *this;
         }
 
@@ -110,16 +180,37 @@ namespace event
             if (!callback)
                 return false;
             // depending on the implementation, input arguments might get ignored
-            // invoke the callback, pass wrapped arguments
-            auto status = (*callback)(args);
+            // invoke the callback, pass wrapped arguments (view without allocation)
+            const auto deadline = getTargetTs();
+            const auto startTs = timesys::ticks();
+            util::ArgsView view(args);
+            auto status = (*callback)(view.get());
             repeats = repeats > 0 ? repeats - 1 : repeats; // remove only if more than zero
             triggered = true;
-            currentTs = timesys::ticks();
+            const auto endTs = timesys::ticks();
+            if (mode == IntervalMode::FixedDelay || type != INTERVAL || timeout <= 0)
+            {
+                currentTs = endTs;
+                return status;
+            }
+            // Fixed rate - the next period starts at the deadline that was just handled
+            currentTs = deadline;
+            if (mode == IntervalMode::Skip && endTs - deadline >= timeout)
+            {
+                const auto skipped = (endTs - deadline) / timeout;
+                currentTs += skipped * timeout; // next deadline is in the future
+                missedPeriods += static_cast<uint64_t>(skipped);
+            }
+            else if (mode == IntervalMode::CatchUp && startTs - deadline >= timeout)
+                missedPeriods++; // fired when the next period already started
             return status;
         }
 
         inline int64_t getTargetTs() const { return currentTs + timeout; }
 
+        /// Latest acceptable firing time (deadline plus slack)
+        inline int64_t getLatestTs() const { return currentTs + timeout + (slack > 0 ? slack : 0); }
+
         inline bool checkCallback(const util::Callback *pCallback) const { return callback.get() == pCallback; }
 
         inline void deactivate(void)
@@ -142,6 +233,30 @@ namespace event
     }; //# struct TimerEntryInfo
     //#-----------------------------------------------------------------------------------
 
+    /**
+     * @brief Entry in the timers schedule (min-heap keyed on the latest firing time, the
+     * deadline plus slack). Entries are never updated in place - when the timer is
+     * removed the generation of its slot changes, the entry becomes stale and is dropped
+     * lazily (or during compaction).
+     */
+    struct TimerScheduleEntry
+    {
+        /// Latest firing time - the heap key
+        int64_t targetTs;
+        /// Deadline - the timer can't fire before that
+        int64_t earliestTs;
+        uint32_t slot;
+        uint32_t generation;
+
+        TimerScheduleEntry() : targetTs(0), earliestTs(0), slot(0), generation(0) {}
+        TimerScheduleEntry(int64_t _targetTs, int64_t _earliestTs, uint32_t _slot, uint32_t _generation)
+            : targetTs(_targetTs), earliestTs(_earliestTs), slot(_slot), generation(_generation) {}
+
+        inline bool operator>(const TimerScheduleEntry &other) const noexcept { return targetTs > other.targetTs; }
+        inline bool operator<(const TimerScheduleEntry &other) const noexcept { return targetTs < other.targetTs; }
+    }; //# struct TimerScheduleEntry
+    //#-----------------------------------------------------------------------------------
+
     struct TimerHelper
     {
         TimerHelper() = delete;
@@ -0,0 +1,282 @@
+#pragma once
+#ifndef FG_INC_TIMER_POOL
+#define FG_INC_TIMER_POOL
+
+#include <event/TimerEntryInfo.hpp>
+
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#include <Queue.hpp>
+
+namespace event
+{
+    /**
+     * @brief Storage for timers with O(1) lookup and cancellation. Timers live in slots
+     * that are reused through a free list (the slot container is node based, so the
+     * addresses stay valid while callbacks are executed). Each slot has a generation
+     * counter - removing a timer only bumps the generation, the entry on the schedule
+     * (min-heap) becomes a tombstone and is dropped lazily. When tombstones outnumber
+     * the live entries the heap is compacted in one pass (amortized O(1) per removal).
+     * Expired timers are released by the owner in the same pass that fired them, when
+     * the last timer is released the slot storage is dropped as well.
+     *
+     * Timers with slack are ordered by the latest firing time. When the schedule is
+     * processed all entries from the top that are already past their deadline are popped
+     * as well, so timers with overlapping windows fire in a single batch.
+     *
+     * This class is not thread safe - the owner is responsible for locking.
+     */
+    class TimerPool
+    {
+    public:
+        using self_type = TimerPool;
+        using size_type = std::size_t;
+
+        /// Minimal number of tombstones on the schedule before compaction is considered
+        static const size_type MIN_TOMBSTONES_TO_COMPACT = 64;
+
+        struct Slot
+        {
+            TimerEntryInfo timer;
+            /// Incremented every time the slot is released, schedule entries with
+            /// a different generation are stale
+            uint32_t generation;
+            /// True if there's a live entry for this slot on the schedule
+            bool scheduled;
+            bool used;
+
+            Slot() : timer(), generation(0), scheduled(false), used(false) {}
+        }; //# struct Slot
+
+        using Slots = std::deque<Slot>;
+        using SlotIndex = std::unordered_map<uint32_t, uint32_t>;
+        using Schedule = PriorityQueue<TimerScheduleEntry,
+                                       std::vector<TimerScheduleEntry>,
+                                       std::greater<TimerScheduleEntry>>;
+
+    public:
+        TimerPool() : m_slots(), m_freeSlots(), m_index(), m_schedule(), m_tombstones(0) {}
+        ~TimerPool() { clear(); }
+
+        TimerPool(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+    public:
+        inline size_type size(void) const noexcept { return m_index.size(); }
+
+        inline bool empty(void) const noexcept { return m_index.empty(); }
+
+        /// Number of stale entries currently sitting on the schedule
+        inline size_type tombstones(void) const noexcept { return m_tombstones; }
+
+        inline size_type scheduleSize(void) const noexcept { return m_schedule.size(); }
+
+        /**
+         * @return Latest firing time of the top schedule entry (might be a tombstone),
+         *         INT64_MAX if the schedule is empty
+         */
+        inline int64_t nextDeadline(void) const { return m_schedule.empty() ? INT64_MAX : m_schedule.top().targetTs; }
+
+        /**
+         * Move the timer into a free slot and put it on the schedule.
+         * @return Timer identifier, zero if the identifier is already in use
+         */
+        uint32_t insert(TimerEntryInfo &&timer)
+        {
+            const auto id = timer.getId();
+            if (!id || m_index.find(id) != m_index.end())
+                return 0;
+            uint32_t slotIdx = 0;
+            if (!m_freeSlots.empty())
+            {
+                slotIdx = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            }
+            else
+            {
+                slotIdx = static_cast<uint32_t>(m_slots.size());
+                m_slots.emplace_back();
+            }
+            auto &slot = m_slots[slotIdx];
+            slot.timer = std::move(timer);
+            slot.used = true;
+            m_index.emplace(id, slotIdx);
+            schedule(slotIdx);
+            return id;
+        }
+
+        TimerEntryInfo *find(const uint32_t id)
+        {
+            auto found = m_index.find(id);
+            if (found == m_index.end())
+                return nullptr;
+            return &m_slots[found->second].timer;
+        }
+
+        TimerEntryInfo const *find(const uint32_t id) const
+        {
+            auto found = m_index.find(id);
+            if (found == m_index.end())
+                return nullptr;
+            return &m_slots[found->second].timer;
+        }
+
+        inline bool contains(const uint32_t id) const { return m_index.find(id) != m_index.end(); }
+
+        /**
+         * Release the slot of a given timer. The timer must not be executing at the time.
+         * @return False if there's no timer with this identifier
+         */
+        bool erase(const uint32_t id)
+        {
+            auto found = m_index.find(id);
+            if (found == m_index.end())
+                return false;
+            const auto slotIdx = found->second;
+            m_index.erase(found);
+            auto &slot = m_slots[slotIdx];
+            if (slot.scheduled)
+                m_tombstones++;
+            slot.timer.reset(); // releases callback and arguments
+            slot.generation++;
+            slot.scheduled = false;
+            slot.used = false;
+            m_freeSlots.push_back(slotIdx);
+            if (m_index.empty())
+                clear(); // nothing is referenced - give back the memory after bursts
+            else if (m_tombstones >= MIN_TOMBSTONES_TO_COMPACT && m_tombstones > m_index.size())
+                compact();
+            return true;
+        }
+
+        /**
+         * Put the timer back on the schedule with its current target timestamp.
+         */
+        bool reschedule(const uint32_t id)
+        {
+            auto found = m_index.find(id);
+            if (found == m_index.end())
+                return false;
+            auto &slot = m_slots[found->second];
+            if (slot.scheduled)
+                return false;
+            schedule(found->second);
+            return true;
+        }
+
+        /**
+         * Put the timer on the schedule again after its deadline or slack was changed -
+         * the previous schedule entry becomes a tombstone. Timers that are not on the
+         * schedule (executing at the moment) are left alone.
+         */
+        bool refresh(const uint32_t id)
+        {
+            auto found = m_index.find(id);
+            if (found == m_index.end())
+                return false;
+            auto &slot = m_slots[found->second];
+            if (!slot.scheduled)
+                return false;
+            slot.generation++;
+            m_tombstones++;
+            schedule(found->second);
+            return true;
+        }
+
+        /**
+         * Pop all schedule entries with the deadline not greater than the given timestamp.
+         * Tombstones are dropped, inactive timers are released right away (not passed
+         * further). Timers with a deadline moved into the future are rescheduled.
+         * @param function Called for every expired timer: void(TimerEntryInfo &)
+         */
+        template <typename Function>
+        size_type popExpired(const int64_t timeStamp, Function &&function)
+        {
+            size_type count = 0;
+            // Entries past their latest firing time are always on top, the ones behind
+            // them that already reached the deadline are batched along
+            while (!m_schedule.empty() && m_schedule.top().earliestTs <= timeStamp)
+            {
+                const auto entry = m_schedule.top();
+                m_schedule.pop();
+                auto &slot = m_slots[entry.slot];
+                if (!slot.used || slot.generation != entry.generation)
+                {
+                    m_tombstones--;
+                    continue; // timer was removed
+                }
+                slot.scheduled = false;
+                if (slot.timer.isInactive())
+                {
+                    erase(slot.timer.getId());
+                    continue;
+                }
+                if (slot.timer.getTargetTs() > timeStamp)
+                {
+                    schedule(entry.slot);
+                    continue;
+                }
+                function(slot.timer);
+                count++;
+            } //# for each expired schedule entry
+            return count;
+        }
+
+        /**
+         * Rebuild the schedule without the stale entries
+         */
+        void compact(void)
+        {
+            m_schedule.remove_if([this](const TimerScheduleEntry &entry)
+                                 { return !m_slots[entry.slot].used || m_slots[entry.slot].generation != entry.generation; });
+            m_tombstones = 0;
+        }
+
+        /**
+         * Call the function for every live timer: void(TimerEntryInfo &)
+         */
+        template <typename Function>
+        void forEach(Function &&function)
+        {
+            for (auto &slot : m_slots)
+            {
+                if (slot.used)
+                    function(slot.timer);
+            }
+        }
+
+        void clear(void)
+        {
+            m_schedule.clear();
+            m_index.clear();
+            m_freeSlots.clear();
+            m_slots.clear();
+            m_tombstones = 0;
+        }
+
+    protected:
+        void schedule(const uint32_t slotIdx)
+        {
+            auto &slot = m_slots[slotIdx];
+            slot.scheduled = true;
+            m_schedule.emplace(slot.timer.getLatestTs(), slot.timer.getTargetTs(), slotIdx, slot.generation);
+        }
+
+    private:
+        /// Node based storage for timers - slots are reused, never removed
+        Slots m_slots;
+        /// Indexes of released slots
+        std::vector<uint32_t> m_freeSlots;
+        /// Timer identifier -> slot index
+        SlotIndex m_index;
+        /// Min-heap of deadlines (may contain tombstones)
+        Schedule m_schedule;
+        /// Number of stale entries on the schedule
+        size_type m_tombstones;
+    }; //# class TimerPool
+} //> namespace event
+
+#endif //> FG_INC_TIMER_POOL
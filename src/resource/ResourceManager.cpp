@@ -238,6 +238,7 @@ resource::Resource *resource::ResourceManager::refreshResource(Resource *pResour
             auto eventMgr = static_cast<event::EventManager *>(m_pEventMgr);
             auto eventStruct = eventMgr->requestEventStruct<event::EventResource, event::Type::ResourceCreated>();
             eventStruct->status = event::EventResource::Created;
+            eventStruct->resourceType = pResource->getResourceType();
             // eventStruct->handle = pResource->getHandle();
             eventMgr->throwEvent(event::Type::ResourceCreated, eventStruct);
         }
@@ -439,6 +440,7 @@ resource::Resource *resource::ResourceManager::request(std::string_view info, co
             auto eventMgr = static_cast<event::EventManager *>(m_pEventMgr);
             auto eventStruct = eventMgr->requestEventStruct<event::EventResource, event::Type::ResourceRequested>();
             eventStruct->status = event::EventResource::Requested;
+            eventStruct->resourceType = resourcePtr->getResourceType();
             // eventStruct->handle = pResource->getHandle();
             eventMgr->throwEvent(event::Type::ResourceRequested, eventStruct);
         }
@@ -71,8 +71,15 @@ bool script::modules::Events::initialize(void)
     m_module.function("setTimeout", &base_type::setTimeout);
     m_module.function("clearInterval", &base_type::clearTimeout);
     m_module.function("clearTimeout", &base_type::clearTimeout);
+    m_module.function("setTimerSlack", &base_type::setTimerSlack);
     m_module.function("addCallback", &Events::addCallback);
     m_module.function("deleteCallback", &Events::deleteCallback);
+    m_module.function("getMetrics", &Events::getMetrics);
+    m_module.function("setMetricsEnabled", &Events::setMetricsEnabled);
+    m_module.function("resetMetrics", &Events::resetMetrics);
+    m_module.function("registerEventType", &Events::registerEventType);
+    m_module.function("getEventTypeName", &Events::getEventTypeName);
+    m_module.function("throwEvent", &Events::throwEvent);
 
     setClassName(isolate, m_class_callback, "Callback");
     setClassName(isolate, m_class_base, "EventBase");
@@ -168,6 +175,7 @@ bool script::modules::Events::initialize(void)
 
     m_class_resource.inherit<event::EventBase>()
         .var("status", &event::EventResource::status)
+        .var("resourceType", &event::EventResource::resourceType)
         .function("getStatusAsString", &event::EventResource::getStatusAsString);
 
     m_class_vertexStream.inherit<event::EventBase>();
@@ -244,6 +252,10 @@ static event::Type getEventTypeFromArgument(v8::Isolate *isolate, script::LocalV
         auto castEventType = magic_enum::enum_cast<event::Type>(stringEventType);
         if (castEventType.has_value())
             return castEventType.value();
+        // custom event types registered at runtime (registerEventType)
+        auto eventMgr = base::ManagerRegistry::instance()->get<event::EventManager>();
+        if (eventMgr)
+            return eventMgr->findEventType(stringEventType);
     }
     else if (eventType->IsInt32() || eventType->IsUint32() || eventType->IsNumber())
     {
@@ -253,6 +265,9 @@ static event::Type getEventTypeFromArgument(v8::Isolate *isolate, script::LocalV
             auto castValue = castMaybeValue.ToChecked();
             if (magic_enum::enum_contains<event::Type>(castValue))
                 return magic_enum::enum_cast<event::Type>(castValue).value();
+            auto eventMgr = base::ManagerRegistry::instance()->get<event::EventManager>();
+            if (eventMgr && eventMgr->isRegisteredEventType(static_cast<event::Type>(castValue)))
+                return static_cast<event::Type>(castValue);
         }
     }
     return event::Type::Invalid;
@@ -337,3 +352,137 @@ void script::modules::Events::deleteCallback(FunctionCallbackInfo const &args)
     args.GetReturnValue().Set(status);
 }
 //>---------------------------------------------------------------------------------------
+
+static v8::Local<v8::Object> histogramToObject(v8::Isolate *isolate, const util::Histogram &histogram)
+{
+    auto context = isolate->GetCurrentContext();
+    auto object = v8::Object::New(isolate);
+    object->Set(context, v8pp::to_v8(isolate, "count"), v8pp::to_v8(isolate, static_cast<double>(histogram.count())));
+    object->Set(context, v8pp::to_v8(isolate, "min"), v8pp::to_v8(isolate, static_cast<double>(histogram.min())));
+    object->Set(context, v8pp::to_v8(isolate, "max"), v8pp::to_v8(isolate, static_cast<double>(histogram.max())));
+    object->Set(context, v8pp::to_v8(isolate, "mean"), v8pp::to_v8(isolate, histogram.mean()));
+    object->Set(context, v8pp::to_v8(isolate, "p50"), v8pp::to_v8(isolate, static_cast<double>(histogram.percentile(50.0))));
+    object->Set(context, v8pp::to_v8(isolate, "p90"), v8pp::to_v8(isolate, static_cast<double>(histogram.percentile(90.0))));
+    object->Set(context, v8pp::to_v8(isolate, "p99"), v8pp::to_v8(isolate, static_cast<double>(histogram.percentile(99.0))));
+    return object;
+} //> histogramToObject(...)
+//>---------------------------------------------------------------------------------------
+
+void script::modules::Events::getMetrics(FunctionCallbackInfo const &args)
+{
+    if (args.Length() < 1)
+    {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    auto isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    auto context = isolate->GetCurrentContext();
+    event::Type nativeEventType = getEventTypeFromArgument(isolate, args[0]);
+    auto eventMgr = base::ManagerRegistry::instance()->get<event::EventManager>();
+    auto pMetrics = eventMgr && nativeEventType != event::Type::Invalid ? eventMgr->getEventMetrics(nativeEventType) : nullptr;
+    if (!pMetrics)
+    {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    // times are in nanoseconds
+    auto object = v8::Object::New(isolate);
+    object->Set(context, v8pp::to_v8(isolate, "thrown"), v8pp::to_v8(isolate, static_cast<double>(pMetrics->thrown.load())));
+    object->Set(context, v8pp::to_v8(isolate, "dispatched"), v8pp::to_v8(isolate, static_cast<double>(pMetrics->dispatched.load())));
+    object->Set(context, v8pp::to_v8(isolate, "callbacks"), v8pp::to_v8(isolate, static_cast<double>(pMetrics->callbacks.load())));
+    object->Set(context, v8pp::to_v8(isolate, "slowestCallbackTime"), v8pp::to_v8(isolate, static_cast<double>(pMetrics->slowestCallbackTime.load())));
+    object->Set(context, v8pp::to_v8(isolate, "queueWait"), histogramToObject(isolate, pMetrics->queueWait));
+    object->Set(context, v8pp::to_v8(isolate, "dispatchTime"), histogramToObject(isolate, pMetrics->dispatchTime));
+    object->Set(context, v8pp::to_v8(isolate, "callbackTime"), histogramToObject(isolate, pMetrics->callbackTime));
+    args.GetReturnValue().Set(object);
+}
+//>---------------------------------------------------------------------------------------
+
+void script::modules::Events::setMetricsEnabled(FunctionCallbackInfo const &args)
+{
+    auto eventMgr = base::ManagerRegistry::instance()->get<event::EventManager>();
+    if (args.Length() < 1 || !eventMgr)
+        return;
+    auto isolate = args.GetIsolate();
+    eventMgr->setMetricsEnabled(args[0]->BooleanValue(isolate));
+}
+//>---------------------------------------------------------------------------------------
+
+void script::modules::Events::resetMetrics(FunctionCallbackInfo const &args)
+{
+    auto eventMgr = base::ManagerRegistry::instance()->get<event::EventManager>();
+    if (eventMgr)
+        eventMgr->resetEventMetrics();
+}
+//>---------------------------------------------------------------------------------------
+
+void script::modules::Events::registerEventType(FunctionCallbackInfo const &args)
+{
+    auto eventMgr = base::ManagerRegistry::instance()->get<event::EventManager>();
+    if (args.Length() < 1 || !args[0]->IsString() || !eventMgr)
+    {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    auto isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    auto name = v8pp::from_v8<std::string>(isolate, args[0]);
+    auto nativeEventType = eventMgr->registerEventType(name);
+    if (nativeEventType == event::Type::Invalid)
+    {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    args.GetReturnValue().Set(static_cast<uint32_t>(nativeEventType));
+}
+//>---------------------------------------------------------------------------------------
+
+void script::modules::Events::getEventTypeName(FunctionCallbackInfo const &args)
+{
+    auto eventMgr = base::ManagerRegistry::instance()->get<event::EventManager>();
+    if (args.Length() < 1 || !eventMgr)
+    {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    auto isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    event::Type nativeEventType = getEventTypeFromArgument(isolate, args[0]);
+    auto name = eventMgr->getEventTypeName(nativeEventType);
+    if (nativeEventType == event::Type::Invalid || name.empty())
+    {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+    args.GetReturnValue().Set(v8pp::to_v8(isolate, name));
+}
+//>---------------------------------------------------------------------------------------
+
+void script::modules::Events::throwEvent(FunctionCallbackInfo const &args)
+{
+    auto eventMgr = base::ManagerRegistry::instance()->get<event::EventManager>();
+    if (args.Length() < 1 || !eventMgr)
+    {
+        args.GetReturnValue().Set(false);
+        return;
+    }
+    auto isolate = args.GetIsolate();
+    v8::HandleScope handle_scope(isolate);
+    // only custom types - standard events carry structures filled in by the engine
+    event::Type nativeEventType = getEventTypeFromArgument(isolate, args[0]);
+    if (!eventMgr->isRegisteredEventType(nativeEventType))
+    {
+        args.GetReturnValue().Set(false);
+        return;
+    }
+    auto pEventStruct = eventMgr->requestEventStruct(nativeEventType);
+    if (!pEventStruct)
+    {
+        args.GetReturnValue().Set(false);
+        return;
+    }
+    // false also when a limited lane dropped the event
+    args.GetReturnValue().Set(eventMgr->throwEvent(nativeEventType, pEventStruct));
+}
+//>---------------------------------------------------------------------------------------
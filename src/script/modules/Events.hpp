@@ -28,6 +28,14 @@ namespace script::modules
         static void addCallback(FunctionCallbackInfo const &args);
         static void deleteCallback(FunctionCallbackInfo const &args);
 
+        static void getMetrics(FunctionCallbackInfo const &args);
+        static void setMetricsEnabled(FunctionCallbackInfo const &args);
+        static void resetMetrics(FunctionCallbackInfo const &args);
+
+        static void registerEventType(FunctionCallbackInfo const &args);
+        static void getEventTypeName(FunctionCallbackInfo const &args);
+        static void throwEvent(FunctionCallbackInfo const &args);
+
     protected:
         v8pp::module m_module;
         v8pp::module m_eventTypes;
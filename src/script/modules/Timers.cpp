@@ -20,6 +20,7 @@ bool script::modules::Timers::instantiateGlobals(LocalContext &context)
     global->Set(context, v8pp::to_v8(isolate, "setTimeout"), v8pp::wrap_function(isolate, "setTimeout", &Timers::setTimeout));
     global->Set(context, v8pp::to_v8(isolate, "clearInterval"), v8pp::wrap_function(isolate, "clearInterval", &Timers::clearTimeout));
     global->Set(context, v8pp::to_v8(isolate, "clearTimeout"), v8pp::wrap_function(isolate, "clearTimeout", &Timers::clearTimeout));
+    global->Set(context, v8pp::to_v8(isolate, "setTimerSlack"), v8pp::wrap_function(isolate, "setTimerSlack", &Timers::setTimerSlack));
     return true;
 } //> instantiateGlobals(...)
 //>---------------------------------------------------------------------------------------
@@ -93,3 +94,11 @@ void script::modules::Timers::clearTimeout(unsigned int handle)
     eventMgr->removeTimer(handle);
 } //> clearTimeout(...)
 //>---------------------------------------------------------------------------------------
+
+bool script::modules::Timers::setTimerSlack(unsigned int handle, int slack)
+{
+    auto managerRegistry = base::ManagerRegistry::instance();
+    auto eventMgr = managerRegistry->get<event::EventManager>();
+    return eventMgr->setTimerSlack(handle, slack);
+} //> setTimerSlack(...)
+//>---------------------------------------------------------------------------------------
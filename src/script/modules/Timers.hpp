@@ -33,6 +33,10 @@ namespace script::modules
         inline static void setTimeout(FunctionCallbackInfo const &args) { setTimerWrapper(1, args); }
 
         static void clearTimeout(unsigned int handle);
+        /**
+         * Let the timer fire up to 'slack' milliseconds late (batched with other timers)
+         */
+        static bool setTimerSlack(unsigned int handle, int slack);
     protected:
         inline static ScriptManager *s_pScriptMgr = nullptr;
     }; //# class Timers
@@ -509,6 +509,12 @@ namespace util
         {
             return WrappedValue(std::string(value), typeid(value).name());
         }
+
+        template <>
+        static WrappedValue wrapInPlace<WrappedValue *, true>(WrappedValue *value, uint32_t tid)
+        {
+            return value ? WrappedValue(*value) : WrappedValue();
+        }
         //>-------------------------------------------------------------------------------
 
         template <typename InputType>
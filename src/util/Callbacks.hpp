@@ -21,11 +21,13 @@ namespace util
         /// already has interface prepared
         std::unique_ptr<BindInfo> m_binding;
         CallbackType m_type;
+        /// Callback does not depend on other callbacks, can be executed concurrently
+        bool m_parallel;
 
     protected:
-        Callback(CallbackType type) : m_type(type), m_binding() {}
-        Callback(CallbackType type, BindInfo *pBinding) : m_type(type), m_binding(pBinding) {}
-        Callback(Callback &&other) noexcept : m_binding(std::move(other.m_binding)), m_type(other.m_type) { other.m_type = 0; }
+        Callback(CallbackType type) : m_type(type), m_binding(), m_parallel(false) {}
+        Callback(CallbackType type, BindInfo *pBinding) : m_type(type), m_binding(pBinding), m_parallel(false) {}
+        Callback(Callback &&other) noexcept : m_binding(std::move(other.m_binding)), m_type(other.m_type), m_parallel(other.m_parallel) { other.m_type = 0; }
 
     public:
         ~Callback() { m_type = CALLBACK_INVALID; }
@@ -35,6 +37,10 @@ namespace util
 
         inline CallbackType getType(void) const { return m_type; }
 
+        inline bool isParallel(void) const { return m_parallel; }
+
+        inline void setParallel(bool toggle) { m_parallel = toggle; }
+
         const BindInfo *getBinding(void) const { return m_binding.get(); }
     }; //# class Callback
     //#-----------------------------------------------------------------------------------
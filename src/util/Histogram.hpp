@@ -0,0 +1,149 @@
+#pragma once
+#ifndef FG_INC_UTIL_HISTOGRAM
+#define FG_INC_UTIL_HISTOGRAM
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace util
+{
+    /**
+     * Log-linear (HDR style) histogram of unsigned values with a fixed memory footprint.
+     * Every power of two range is split into 2^SUB_BITS linear buckets, so the relative
+     * error of reported values is bounded (~6% for 4 sub bits) regardless of magnitude.
+     * Values up to 2^MAX_BITS are tracked, larger ones are clamped to the last bucket.
+     *
+     * Recording is lock-free (relaxed atomic increments) and can be done from many
+     * threads, reading is approximate while values are being recorded.
+     */
+    class Histogram
+    {
+    public:
+        using self_type = Histogram;
+        using size_type = std::size_t;
+        using value_type = uint64_t;
+
+        static constexpr unsigned int SUB_BITS = 4;
+        static constexpr unsigned int MAX_BITS = 36;
+        static constexpr size_type SUB_COUNT = size_type(1) << SUB_BITS;
+        static constexpr size_type NUM_BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+        static constexpr value_type MAX_VALUE = (value_type(1) << MAX_BITS) - 1;
+
+    public:
+        Histogram() : m_buckets(), m_count(0), m_sum(0), m_min(UINT64_MAX), m_max(0) { reset(); }
+
+        Histogram(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+    public:
+        static size_type bucketIndex(value_type value) noexcept
+        {
+            if (value > MAX_VALUE)
+                value = MAX_VALUE;
+            if (value < SUB_COUNT)
+                return static_cast<size_type>(value);
+            unsigned int msb = 0;
+            for (auto tmp = value; tmp >>= 1;)
+                msb++;
+            const auto group = msb - SUB_BITS + 1;
+            const auto sub = (value >> (msb - SUB_BITS)) & (SUB_COUNT - 1);
+            return group * SUB_COUNT + static_cast<size_type>(sub);
+        }
+
+        /// Lowest value that falls into the bucket
+        static value_type bucketLowerBound(size_type index) noexcept
+        {
+            const auto group = index / SUB_COUNT;
+            const auto sub = index % SUB_COUNT;
+            if (!group)
+                return static_cast<value_type>(sub);
+            return static_cast<value_type>(SUB_COUNT + sub) << (group - 1);
+        }
+
+        /// Highest value that falls into the bucket
+        static value_type bucketUpperBound(size_type index) noexcept
+        {
+            if (index + 1 >= NUM_BUCKETS)
+                return MAX_VALUE;
+            return bucketLowerBound(index + 1) - 1;
+        }
+
+        void record(value_type value) noexcept
+        {
+            m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            m_sum.fetch_add(value, std::memory_order_relaxed);
+            auto current = m_min.load(std::memory_order_relaxed);
+            while (value < current && !m_min.compare_exchange_weak(current, value, std::memory_order_relaxed))
+                continue;
+            current = m_max.load(std::memory_order_relaxed);
+            while (value > current && !m_max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+                continue;
+        }
+
+        inline uint64_t count(void) const noexcept { return m_count.load(std::memory_order_relaxed); }
+
+        inline value_type sum(void) const noexcept { return m_sum.load(std::memory_order_relaxed); }
+
+        inline value_type min(void) const noexcept { return count() ? m_min.load(std::memory_order_relaxed) : 0; }
+
+        inline value_type max(void) const noexcept { return m_max.load(std::memory_order_relaxed); }
+
+        inline double mean(void) const noexcept
+        {
+            const auto total = count();
+            return total ? static_cast<double>(sum()) / static_cast<double>(total) : 0.0;
+        }
+
+        /**
+         * Value at the given percentile (0-100) - upper bound of the matching bucket
+         * (never greater than the recorded maximum)
+         */
+        value_type percentile(double percent) const noexcept
+        {
+            const auto total = count();
+            if (!total)
+                return 0;
+            if (percent < 0.0)
+                percent = 0.0;
+            if (percent > 100.0)
+                percent = 100.0;
+            auto target = static_cast<uint64_t>(percent / 100.0 * static_cast<double>(total) + 0.5);
+            if (target < 1)
+                target = 1;
+            uint64_t seen = 0;
+            for (size_type idx = 0; idx < NUM_BUCKETS; idx++)
+            {
+                seen += m_buckets[idx].load(std::memory_order_relaxed);
+                if (seen >= target)
+                {
+                    const auto upper = bucketUpperBound(idx);
+                    const auto highest = max();
+                    return upper < highest ? upper : highest;
+                }
+            }
+            return max();
+        }
+
+        void reset(void) noexcept
+        {
+            for (auto &bucket : m_buckets)
+                bucket.store(0, std::memory_order_relaxed);
+            m_count.store(0, std::memory_order_relaxed);
+            m_sum.store(0, std::memory_order_relaxed);
+            m_min.store(UINT64_MAX, std::memory_order_relaxed);
+            m_max.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, NUM_BUCKETS> m_buckets;
+        std::atomic<uint64_t> m_count;
+        std::atomic<value_type> m_sum;
+        std::atomic<value_type> m_min;
+        std::atomic<value_type> m_max;
+    }; //# class Histogram
+} //> namespace util
+
+#endif //> FG_INC_UTIL_HISTOGRAM
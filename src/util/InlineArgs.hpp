@@ -0,0 +1,185 @@
+#pragma once
+#ifndef FG_INC_UTIL_INLINE_ARGS
+#define FG_INC_UTIL_INLINE_ARGS
+
+#include <util/Bindings.hpp>
+
+#include <array>
+#include <deque>
+
+namespace util
+{
+    /**
+     * Argument list with a small buffer - the first N values are stored inline (no heap
+     * allocation per argument), any further values spill to heap allocated wrapped
+     * values. Values passed in as an already allocated WrappedArgs list are adopted
+     * as they are (ownership of the pointers is moved).
+     *
+     * Callbacks expect the WrappedArgs (vector of pointers) - use the ArgsView scope
+     * to get a temporary pointer list without allocating.
+     */
+    template <std::size_t N>
+    class InlineArgs
+    {
+    public:
+        using self_type = InlineArgs<N>;
+        using size_type = std::size_t;
+
+        static const size_type INLINE_CAPACITY = N;
+
+    public:
+        InlineArgs() : m_inline(), m_count(0), m_spill() {}
+
+        explicit InlineArgs(WrappedArgs &&args) : m_inline(), m_count(0), m_spill(std::move(args)) { args.clear(); }
+
+        ~InlineArgs() { reset(); }
+
+        InlineArgs(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+        InlineArgs(self_type &&other) noexcept : m_inline(), m_count(other.m_count), m_spill(std::move(other.m_spill))
+        {
+            for (size_type idx = 0; idx < m_count; idx++)
+                m_inline[idx] = std::move(other.m_inline[idx]);
+            other.m_count = 0;
+            other.m_spill.clear();
+        }
+
+        self_type &operator=(self_type &&other) noexcept
+        {
+            if (this == &other)
+                return *this;
+            reset();
+            m_count = other.m_count;
+            for (size_type idx = 0; idx < m_count; idx++)
+                m_inline[idx] = std::move(other.m_inline[idx]);
+            m_spill = std::move(other.m_spill);
+            other.m_count = 0;
+            other.m_spill.clear();
+            return *this;
+        }
+
+    public:
+        inline size_type size(void) const noexcept { return m_count + m_spill.size(); }
+
+        inline bool empty(void) const noexcept { return size() == 0; }
+
+        /// Number of values that live on the heap
+        inline size_type spilled(void) const noexcept { return m_spill.size(); }
+
+        WrappedValue *operator[](size_type index)
+        {
+            if (index < m_count)
+                return &m_inline[index];
+            return m_spill[index - m_count];
+        }
+
+        const WrappedValue *operator[](size_type index) const { return const_cast<self_type *>(this)->operator[](index); }
+
+        /**
+         * Append the value - stored inline while there's room (and nothing spilled yet,
+         * so the order is preserved).
+         */
+        void push(WrappedValue &&value)
+        {
+            if (m_count < N && m_spill.empty())
+                m_inline[m_count++] = std::move(value);
+            else
+                m_spill.push_back(new WrappedValue(std::move(value)));
+        }
+
+        /**
+         * Take ownership of already allocated values (appended at the end)
+         */
+        void adopt(WrappedArgs &&args)
+        {
+            if (m_spill.empty())
+                m_spill = std::move(args);
+            else
+                m_spill.insert(m_spill.end(), args.begin(), args.end());
+            args.clear();
+        }
+
+        /**
+         * Replace the contents with a deep copy of the given values (inline if possible)
+         */
+        void assign(const WrappedArgs &args)
+        {
+            reset();
+            for (auto pValue : args)
+            {
+                if (pValue)
+                    push(WrappedValue(*pValue));
+            }
+        }
+
+        /**
+         * Fill the pointer list (cleared first) with addresses of all values. Pointers
+         * are valid as long as this object is not modified or moved.
+         */
+        void view(WrappedArgs &output)
+        {
+            output.clear();
+            for (size_type idx = 0; idx < m_count; idx++)
+                output.push_back(&m_inline[idx]);
+            output.insert(output.end(), m_spill.begin(), m_spill.end());
+        }
+
+        void reset(void)
+        {
+            for (size_type idx = 0; idx < m_count; idx++)
+                m_inline[idx].reset();
+            m_count = 0;
+            reset_arguments(m_spill);
+        }
+
+    private:
+        std::array<WrappedValue, N> m_inline;
+        size_type m_count;
+        WrappedArgs m_spill;
+    }; //# class InlineArgs
+    //#-----------------------------------------------------------------------------------
+
+    /**
+     * Scope that borrows a pointer list from a thread-local stack - after the first use
+     * the list is reused so building a WrappedArgs view does not allocate. Scopes can be
+     * nested (dispatch from within a callback).
+     */
+    class ArgsView
+    {
+    public:
+        ArgsView() : m_args(acquire()) {}
+
+        template <std::size_t N>
+        explicit ArgsView(InlineArgs<N> &args) : m_args(acquire()) { args.view(m_args); }
+
+        ~ArgsView()
+        {
+            m_args.clear(); // capacity is retained
+            s_depth--;
+        }
+
+        ArgsView(const ArgsView &other) = delete;
+        ArgsView &operator=(const ArgsView &other) = delete;
+
+        inline WrappedArgs &get(void) noexcept { return m_args; }
+
+        inline operator WrappedArgs &() noexcept { return m_args; }
+
+    private:
+        static WrappedArgs &acquire(void)
+        {
+            // deque - references to the lists stay valid when the stack grows
+            if (s_stack.size() <= s_depth)
+                s_stack.emplace_back();
+            return s_stack[s_depth++];
+        }
+
+        inline static thread_local std::deque<WrappedArgs> s_stack;
+        inline static thread_local std::size_t s_depth = 0;
+
+        WrappedArgs &m_args;
+    }; //# class ArgsView
+} //> namespace util
+
+#endif //> FG_INC_UTIL_INLINE_ARGS
@@ -0,0 +1,291 @@
+#pragma once
+#ifndef FG_INC_UTIL_MPSC_QUEUE
+#define FG_INC_UTIL_MPSC_QUEUE
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <new>
+#include <utility>
+
+namespace util
+{
+    /**
+     * Bounded lock-free ring for multiple producers and a single consumer, with an
+     * unbounded (mutex protected) overflow path. Producers never block on each other
+     * while the ring has free cells - each cell carries a sequence number so reserving
+     * a position is a single CAS on the enqueue counter (Vyukov style bounded queue).
+     *
+     * When the ring is full the value is appended to the overflow deque and the queue
+     * switches into 'overflowing' mode - all following pushes go straight to overflow
+     * until the consumer drains it, so the order of values from a single producer is
+     * preserved.
+     *
+     * Only one thread at a time can call drain() / pop().
+     */
+    template <typename TValueType>
+    class MpscQueue
+    {
+    public:
+        using self_type = MpscQueue<TValueType>;
+        using value_type = TValueType;
+        using size_type = std::size_t;
+
+        /// Default number of cells in the ring (needs to be a power of two)
+        static const size_type DEFAULT_CAPACITY = 1024;
+
+    protected:
+        struct Cell
+        {
+            std::atomic<size_type> sequence;
+            alignas(TValueType) unsigned char storage[sizeof(TValueType)];
+
+            inline TValueType *value(void) noexcept { return std::launder(reinterpret_cast<TValueType *>(storage)); }
+        }; //# struct Cell
+
+    public:
+        explicit MpscQueue(size_type capacity = DEFAULT_CAPACITY)
+            : m_mask(roundCapacity(capacity) - 1),
+              m_cells(new Cell[roundCapacity(capacity)]),
+              m_enqueuePos(0),
+              m_dequeuePos(0),
+              m_overflowing(false),
+              m_mutexOverflow(),
+              m_overflow(),
+              m_drainBuffer()
+        {
+            for (size_type idx = 0; idx <= m_mask; idx++)
+                m_cells[idx].sequence.store(idx, std::memory_order_relaxed);
+        }
+
+        ~MpscQueue() { clear(); }
+
+        MpscQueue(const self_type &other) = delete;
+        MpscQueue(self_type &&other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+        self_type &operator=(self_type &&other) = delete;
+
+    public:
+        inline size_type capacity(void) const noexcept { return m_mask + 1; }
+
+        /**
+         * Approximate number of values waiting in the queue (ring + overflow).
+         * Meant for metrics only - the value can be stale as soon as it's returned.
+         */
+        size_type size(void) const
+        {
+            const auto enqueued = m_enqueuePos.load(std::memory_order_acquire);
+            const auto dequeued = m_dequeuePos.load(std::memory_order_acquire);
+            size_type count = enqueued > dequeued ? enqueued - dequeued : 0;
+            if (m_overflowing.load(std::memory_order_acquire))
+            {
+                const std::lock_guard<std::mutex> lock(m_mutexOverflow);
+                count += m_overflow.size();
+            }
+            return count;
+        }
+
+        inline bool empty(void) const { return size() == 0; }
+
+        inline bool isOverflowing(void) const noexcept { return m_overflowing.load(std::memory_order_acquire); }
+
+        /**
+         * Push the value into the queue - this never fails, if the ring is full the
+         * value is moved into the overflow container.
+         * @return True if the value landed in the lock-free ring, false on overflow path.
+         */
+        bool push(TValueType &&value)
+        {
+            if (!m_overflowing.load(std::memory_order_acquire) && tryPush(value))
+                return true;
+            const std::lock_guard<std::mutex> lock(m_mutexOverflow);
+            m_overflowing.store(true, std::memory_order_release);
+            m_overflow.emplace_back(std::move(value));
+            return false;
+        }
+
+        template <typename... Args>
+        inline bool emplace(Args &&...args) { return push(TValueType(std::forward<Args>(args)...)); }
+
+        /**
+         * Push the values as one contiguous block - the positions are reserved with a
+         * single CAS, if there's not enough room in the ring the whole block goes to the
+         * overflow container (single lock). Values from the block are never interleaved
+         * with values from other producers.
+         * @return True if the block landed in the lock-free ring, false on overflow path.
+         */
+        bool pushBatch(TValueType *values, size_type count)
+        {
+            if (!values || !count)
+                return true;
+            if (!m_overflowing.load(std::memory_order_acquire) && tryPushBatch(values, count))
+                return true;
+            const std::lock_guard<std::mutex> lock(m_mutexOverflow);
+            m_overflowing.store(true, std::memory_order_release);
+            for (size_type idx = 0; idx < count; idx++)
+                m_overflow.emplace_back(std::move(values[idx]));
+            return false;
+        }
+
+        /**
+         * Remove a single value from the front of the ring (overflow is not checked).
+         * @return False if the ring is empty or the front cell is not yet published.
+         */
+        bool pop(TValueType &output)
+        {
+            const auto pos = m_dequeuePos.load(std::memory_order_relaxed);
+            auto &cell = m_cells[pos & m_mask];
+            if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+                return false;
+            output = std::move(*cell.value());
+            cell.value()->~TValueType();
+            cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+            m_dequeuePos.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Drain everything that was pushed before this call, in FIFO order. Values pushed
+         * by the function itself (or concurrently) are left for the next drain. The
+         * function receives an rvalue reference and may move from it. The ring is drained
+         * without allocating, the overflow path reuses an internal buffer.
+         * @return Number of values passed to the function
+         */
+        template <typename Function>
+        size_type drain(Function &&function)
+        {
+            if (!m_overflowing.load(std::memory_order_acquire))
+                return drainRing(m_enqueuePos.load(std::memory_order_acquire), function);
+            /* lock overflow */ {
+                // Take the whole snapshot before calling the function. Anything published
+                // to the ring is older than the overflowing values (producers switch to
+                // the overflow path as soon as it's active).
+                const std::lock_guard<std::mutex> lock(m_mutexOverflow);
+                drainRing(m_enqueuePos.load(std::memory_order_acquire), [this](TValueType &&value)
+                          { m_drainBuffer.emplace_back(std::move(value)); });
+                for (auto &it : m_overflow)
+                    m_drainBuffer.emplace_back(std::move(it));
+                m_overflow.clear();
+                m_overflowing.store(false, std::memory_order_release);
+            }
+            // process outside of the lock - function can push new values
+            for (auto &it : m_drainBuffer)
+                function(std::move(it));
+            const auto count = m_drainBuffer.size();
+            m_drainBuffer.clear(); // capacity is retained
+            return count;
+        }
+
+        /**
+         * Destroy all values waiting in the queue (consumer side).
+         */
+        void clear(void)
+        {
+            drain([](TValueType &&value)
+                  { TValueType discard(std::move(value)); });
+        }
+
+    protected:
+        static size_type roundCapacity(size_type capacity)
+        {
+            size_type rounded = 2;
+            while (rounded < capacity)
+                rounded <<= 1;
+            return rounded;
+        }
+
+        bool tryPush(TValueType &value)
+        {
+            auto pos = m_enqueuePos.load(std::memory_order_relaxed);
+            Cell *cell = nullptr;
+            while (true)
+            {
+                cell = &m_cells[pos & m_mask];
+                const auto sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+                if (diff == 0)
+                {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false; // ring is full
+                else
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+            new (cell->storage) TValueType(std::move(value));
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool tryPushBatch(TValueType *values, size_type count)
+        {
+            if (count > capacity())
+                return false;
+            auto pos = m_enqueuePos.load(std::memory_order_relaxed);
+            while (true)
+            {
+                // The consumer frees the cells in order - if the last cell of the block
+                // is free in this lap, all the cells before it are free as well
+                auto &last = m_cells[(pos + count - 1) & m_mask];
+                const auto sequence = last.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + count - 1);
+                if (diff == 0)
+                {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false; // not enough room
+                else
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+            for (size_type idx = 0; idx < count; idx++)
+            {
+                auto &cell = m_cells[(pos + idx) & m_mask];
+                new (cell.storage) TValueType(std::move(values[idx]));
+                cell.sequence.store(pos + idx + 1, std::memory_order_release);
+            }
+            return true;
+        }
+
+        template <typename Function>
+        size_type drainRing(size_type limit, Function &&function)
+        {
+            size_type count = 0;
+            auto pos = m_dequeuePos.load(std::memory_order_relaxed);
+            while (pos < limit)
+            {
+                auto &cell = m_cells[pos & m_mask];
+                if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+                    break; // reserved but not yet published - pick it up next time
+                {
+                    TValueType value(std::move(*cell.value()));
+                    cell.value()->~TValueType();
+                    cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    pos++;
+                    m_dequeuePos.store(pos, std::memory_order_release);
+                    function(std::move(value));
+                }
+                count++;
+            }
+            return count;
+        }
+
+    private:
+        const size_type m_mask;
+        std::unique_ptr<Cell[]> m_cells;
+        alignas(64) std::atomic<size_type> m_enqueuePos;
+        alignas(64) std::atomic<size_type> m_dequeuePos;
+        alignas(64) std::atomic_bool m_overflowing;
+        mutable std::mutex m_mutexOverflow;
+        std::deque<TValueType> m_overflow;
+        std::vector<TValueType> m_drainBuffer;
+    }; //# class MpscQueue
+} //> namespace util
+
+#endif //> FG_INC_UTIL_MPSC_QUEUE
@@ -0,0 +1,480 @@
+#pragma once
+#ifndef FG_INC_UTIL_SLAB_POOL
+#define FG_INC_UTIL_SLAB_POOL
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <array>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace util
+{
+    /**
+     * Thread safe fixed size object pool. Objects are carved from aligned slabs that
+     * are never released before the pool itself is destroyed, so the ownership check
+     * is O(1): the pointer is masked down to the slab base and looked up in a small
+     * lock-free hash set of slab addresses.
+     *
+     * Free objects are kept on a global lock-free stack (tagged index, ABA safe) and
+     * on a thread-local magazine for every pool the thread touches, so the common
+     * create/destroy path does not touch shared state at all. New slabs are allocated
+     * under a mutex.
+     *
+     * Notes:
+     * - The pool does not call destructors of objects that are still alive when the
+     *   pool is destroyed (it just releases the memory).
+     * - Magazines evicted by a thread that uses more than MAX_THREAD_MAGAZINES pools,
+     *   and magazines of a thread that exits, are flushed back to the global list of
+     *   their pool if it's still alive (pools are registered by identifier).
+     * - Once all MAX_SLABS slabs are used up, objects are allocated on the heap one by
+     *   one (slow path, tracked in a set under a mutex) - create() does not fail.
+     */
+    template <typename TValueType, std::size_t TSlabBytes = 16384>
+    class SlabPool
+    {
+    public:
+        using self_type = SlabPool<TValueType, TSlabBytes>;
+        using value_type = TValueType;
+        using size_type = std::size_t;
+
+        static_assert((TSlabBytes & (TSlabBytes - 1)) == 0, "Slab size needs to be a power of two");
+
+        /// Maximum number of slabs for a single pool
+        static const size_type MAX_SLABS = 1024;
+        /// Number of objects cached per thread (per pool)
+        static const uint32_t MAGAZINE_SIZE = 32;
+        /// Number of different pools a single thread can cache objects for
+        static const size_type MAX_THREAD_MAGAZINES = 4;
+
+    protected:
+        struct Node
+        {
+            /// Next free node (index + 1, zero terminates the list)
+            std::atomic<uint32_t> next;
+            /// Set while the object is handed out - guards against double release
+            std::atomic_bool used;
+            alignas(TValueType) unsigned char storage[sizeof(TValueType)];
+
+            inline TValueType *value(void) noexcept { return std::launder(reinterpret_cast<TValueType *>(storage)); }
+        }; //# struct Node
+
+    public:
+        static const size_type NODES_PER_SLAB = TSlabBytes / sizeof(Node);
+        static_assert(NODES_PER_SLAB > 0, "Slab size is too small for the value type");
+
+    protected:
+        struct Slab
+        {
+            Node nodes[NODES_PER_SLAB];
+
+            Slab()
+            {
+                for (auto &node : nodes)
+                {
+                    node.next.store(0, std::memory_order_relaxed);
+                    node.used.store(false, std::memory_order_relaxed);
+                }
+            }
+        }; //# struct Slab
+
+        struct Magazine
+        {
+            uint64_t poolId;
+            uint32_t count;
+            uint32_t items[MAGAZINE_SIZE];
+        }; //# struct Magazine
+
+        /// Magazines of a single thread - flushed when the thread exits
+        struct ThreadMagazines
+        {
+            std::array<Magazine, MAX_THREAD_MAGAZINES> magazines;
+            size_type evict;
+
+            ThreadMagazines() : magazines(), evict(0) {}
+            ~ThreadMagazines()
+            {
+                for (auto &it : magazines)
+                    flushMagazine(it);
+            }
+        }; //# struct ThreadMagazines
+
+        /// Pools that are alive - the liveness check before a magazine is flushed
+        struct LivePools
+        {
+            std::mutex mutex;
+            std::unordered_map<uint64_t, self_type *> pools;
+        }; //# struct LivePools
+
+        static const size_type HASH_SIZE = MAX_SLABS * 2;
+
+    public:
+        SlabPool() : m_poolId(nextPoolId()), m_freeHead(0), m_slabCount(0), m_mutexGrow(),
+                     m_overflowCount(0), m_mutexOverflow(), m_overflow()
+        {
+            for (auto &slab : m_slabs)
+                slab.store(nullptr, std::memory_order_relaxed);
+            for (auto &key : m_hashKeys)
+                key.store(0, std::memory_order_relaxed);
+            for (auto &value : m_hashValues)
+                value.store(0, std::memory_order_relaxed);
+            auto &live = livePools();
+            const std::lock_guard<std::mutex> lock(live.mutex);
+            live.pools.emplace(m_poolId, this);
+        }
+
+        ~SlabPool()
+        {
+            /* lock live pools */ {
+                // no magazine can be flushed into this pool from now on
+                auto &live = livePools();
+                const std::lock_guard<std::mutex> lock(live.mutex);
+                live.pools.erase(m_poolId);
+            }
+            const auto count = m_slabCount.load(std::memory_order_acquire);
+            for (size_type idx = 0; idx < count; idx++)
+            {
+                auto pSlab = m_slabs[idx].exchange(nullptr);
+                if (!pSlab)
+                    continue;
+                pSlab->~Slab();
+                ::operator delete(pSlab, std::align_val_t(TSlabBytes));
+            }
+            for (auto pMemory : m_overflow)
+                ::operator delete(const_cast<void *>(pMemory), std::align_val_t(alignof(TValueType)));
+            m_overflow.clear();
+        }
+
+        SlabPool(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+    public:
+        /// Total number of object slots allocated (in use + free)
+        inline size_type capacity(void) const noexcept { return m_slabCount.load(std::memory_order_acquire) * NODES_PER_SLAB; }
+
+        /**
+         * Make sure that at least 'count' slots are allocated
+         */
+        void reserve(size_type count)
+        {
+            while (capacity() < count)
+            {
+                if (!grow())
+                    break;
+            }
+        }
+
+        /**
+         * Construct the object in a free slot (on the heap if all MAX_SLABS slabs are
+         * full). Safe to call from any thread.
+         * @return Pointer to the new object
+         */
+        template <typename... Args>
+        TValueType *create(Args &&...args)
+        {
+            uint32_t index = 0;
+            if (!acquire(index))
+                return createOverflow(std::forward<Args>(args)...); //! Lock - overflow
+            auto &node = nodeAt(index);
+            node.used.store(true, std::memory_order_relaxed);
+            return new (node.storage) TValueType(std::forward<Args>(args)...);
+        }
+
+        /**
+         * Destroy the object and put its slot back on the free list. Pointers not owned
+         * by this pool and objects that are already released are ignored.
+         * @return True if the object was released
+         */
+        bool destroy(TValueType *pObject)
+        {
+            uint32_t index = 0;
+            if (!indexOf(pObject, index))
+                return destroyOverflow(pObject); //! Lock - overflow
+            auto &node = nodeAt(index);
+            if (!node.used.exchange(false, std::memory_order_acq_rel))
+                return false; // double release
+            node.value()->~TValueType();
+            release(index);
+            return true;
+        }
+
+        /**
+         * Check if the pointer points to an object slot from this pool - O(1), does not
+         * dereference the pointer.
+         */
+        inline bool owns(const void *pointer) const
+        {
+            uint32_t index = 0;
+            return indexOf(pointer, index) || isOverflow(pointer);
+        }
+
+        /**
+         * Check if the pointer points to an object that is currently handed out
+         */
+        inline bool isAlive(const void *pointer) const
+        {
+            uint32_t index = 0;
+            if (!indexOf(pointer, index))
+                return isOverflow(pointer); // heap objects are tracked only while alive
+            return const_cast<self_type *>(this)->nodeAt(index).used.load(std::memory_order_acquire);
+        }
+
+        /// Number of objects currently allocated on the heap (pool exhausted)
+        inline size_type overflowCount(void) const noexcept { return m_overflowCount.load(std::memory_order_acquire); }
+
+    protected:
+        static uint64_t nextPoolId(void)
+        {
+            static std::atomic<uint64_t> s_poolId(0);
+            return ++s_poolId;
+        }
+
+        static LivePools &livePools(void)
+        {
+            static LivePools s_livePools;
+            return s_livePools;
+        }
+
+        /**
+         * Return the cached slots to the owning pool (dropped if the pool is gone) and
+         * clear the magazine
+         */
+        static void flushMagazine(Magazine &magazine)
+        {
+            if (magazine.poolId && magazine.count)
+            {
+                auto &live = livePools();
+                const std::lock_guard<std::mutex> lock(live.mutex);
+                auto found = live.pools.find(magazine.poolId);
+                if (found != live.pools.end())
+                {
+                    while (magazine.count)
+                        found->second->pushGlobal(magazine.items[--magazine.count]);
+                }
+            }
+            magazine.poolId = 0;
+            magazine.count = 0;
+        }
+
+        template <typename... Args>
+        TValueType *createOverflow(Args &&...args)
+        {
+            auto pMemory = ::operator new(sizeof(TValueType), std::align_val_t(alignof(TValueType)));
+            TValueType *pObject = nullptr;
+            try
+            {
+                pObject = new (pMemory) TValueType(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                ::operator delete(pMemory, std::align_val_t(alignof(TValueType)));
+                throw;
+            }
+            const std::lock_guard<std::mutex> lock(m_mutexOverflow);
+            m_overflow.insert(pMemory);
+            m_overflowCount.store(m_overflow.size(), std::memory_order_release);
+            return pObject;
+        }
+
+        bool destroyOverflow(TValueType *pObject)
+        {
+            if (!pObject || !m_overflowCount.load(std::memory_order_acquire))
+                return false;
+            /* lock mutex overflow */ {
+                const std::lock_guard<std::mutex> lock(m_mutexOverflow);
+                if (!m_overflow.erase(pObject))
+                    return false; // not ours or already released
+                m_overflowCount.store(m_overflow.size(), std::memory_order_release);
+            }
+            pObject->~TValueType();
+            ::operator delete(static_cast<void *>(pObject), std::align_val_t(alignof(TValueType)));
+            return true;
+        }
+
+        bool isOverflow(const void *pointer) const
+        {
+            if (!pointer || !m_overflowCount.load(std::memory_order_acquire))
+                return false;
+            const std::lock_guard<std::mutex> lock(m_mutexOverflow);
+            return m_overflow.find(pointer) != m_overflow.end();
+        }
+
+        static inline size_type hashSlot(uintptr_t base) noexcept { return (base / TSlabBytes) % HASH_SIZE; }
+
+        inline Node &nodeAt(uint32_t index) noexcept
+        {
+            auto pSlab = m_slabs[index / NODES_PER_SLAB].load(std::memory_order_acquire);
+            return pSlab->nodes[index % NODES_PER_SLAB];
+        }
+
+        bool indexOf(const void *pointer, uint32_t &index) const
+        {
+            if (!pointer)
+                return false;
+            const auto address = reinterpret_cast<uintptr_t>(pointer);
+            const auto base = address & ~(uintptr_t(TSlabBytes) - 1);
+            auto hashIdx = hashSlot(base);
+            for (size_type probe = 0; probe < HASH_SIZE; probe++)
+            {
+                const auto key = m_hashKeys[hashIdx].load(std::memory_order_acquire);
+                if (!key)
+                    return false; // empty bucket - not one of our slabs
+                if (key == base)
+                {
+                    const auto slabIdx = m_hashValues[hashIdx].load(std::memory_order_relaxed);
+                    if (address - base < offsetof(Node, storage))
+                        return false;
+                    const auto offset = address - base - offsetof(Node, storage);
+                    if (offset % sizeof(Node) != 0)
+                        return false; // points inside of a slab, but not at an object
+                    const auto nodeIdx = offset / sizeof(Node);
+                    if (nodeIdx >= NODES_PER_SLAB)
+                        return false;
+                    index = static_cast<uint32_t>(slabIdx * NODES_PER_SLAB + nodeIdx);
+                    return true;
+                }
+                hashIdx = (hashIdx + 1) % HASH_SIZE;
+            }
+            return false;
+        }
+
+        Magazine *magazine(void)
+        {
+            static thread_local ThreadMagazines tl_magazines;
+            for (auto &it : tl_magazines.magazines)
+            {
+                if (it.poolId == m_poolId)
+                    return &it;
+            }
+            for (auto &it : tl_magazines.magazines)
+            {
+                if (!it.poolId)
+                {
+                    it.poolId = m_poolId;
+                    it.count = 0;
+                    return &it;
+                }
+            }
+            // All magazines are taken - reuse one, the cached slots go back to their pool
+            auto &evicted = tl_magazines.magazines[tl_magazines.evict++ % MAX_THREAD_MAGAZINES];
+            flushMagazine(evicted); //! Lock - live pools
+            evicted.poolId = m_poolId;
+            return &evicted;
+        }
+
+        bool popGlobal(uint32_t &index)
+        {
+            auto head = m_freeHead.load(std::memory_order_acquire);
+            while (static_cast<uint32_t>(head) != 0)
+            {
+                const uint32_t top = static_cast<uint32_t>(head) - 1;
+                const uint32_t next = nodeAt(top).next.load(std::memory_order_relaxed);
+                const uint64_t replacement = (((head >> 32) + 1) << 32) | next;
+                if (m_freeHead.compare_exchange_weak(head, replacement,
+                                                     std::memory_order_acq_rel,
+                                                     std::memory_order_acquire))
+                {
+                    index = top;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void pushGlobal(uint32_t index)
+        {
+            auto &node = nodeAt(index);
+            auto head = m_freeHead.load(std::memory_order_relaxed);
+            uint64_t replacement = 0;
+            do
+            {
+                node.next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+                replacement = (((head >> 32) + 1) << 32) | (uint64_t(index) + 1);
+            } while (!m_freeHead.compare_exchange_weak(head, replacement,
+                                                       std::memory_order_release,
+                                                       std::memory_order_relaxed));
+        }
+
+        bool acquire(uint32_t &index)
+        {
+            auto pMagazine = magazine();
+            if (pMagazine->count)
+            {
+                index = pMagazine->items[--pMagazine->count];
+                return true;
+            }
+            // refill half of the magazine from the global list, grow if it's empty
+            while (true)
+            {
+                while (pMagazine->count < MAGAZINE_SIZE / 2 && popGlobal(index))
+                    pMagazine->items[pMagazine->count++] = index;
+                if (pMagazine->count)
+                {
+                    index = pMagazine->items[--pMagazine->count];
+                    return true;
+                }
+                if (!grow())
+                    return popGlobal(index);
+            }
+        }
+
+        void release(uint32_t index)
+        {
+            auto pMagazine = magazine();
+            if (pMagazine->count == MAGAZINE_SIZE)
+            {
+                // return half of the cached slots so other threads can use them
+                while (pMagazine->count > MAGAZINE_SIZE / 2)
+                    pushGlobal(pMagazine->items[--pMagazine->count]);
+            }
+            pMagazine->items[pMagazine->count++] = index;
+        }
+
+        bool grow(void)
+        {
+            const std::lock_guard<std::mutex> lock(m_mutexGrow);
+            const auto slabIdx = m_slabCount.load(std::memory_order_relaxed);
+            if (slabIdx >= MAX_SLABS)
+                return false;
+            // aligned to its size - slab base is found by masking the object address
+            auto pSlab = new (::operator new(TSlabBytes, std::align_val_t(TSlabBytes))) Slab();
+            m_slabs[slabIdx].store(pSlab, std::memory_order_release);
+            // register the slab base for ownership checks (value first, then the key)
+            const auto base = reinterpret_cast<uintptr_t>(pSlab);
+            auto hashIdx = hashSlot(base);
+            while (m_hashKeys[hashIdx].load(std::memory_order_relaxed) != 0)
+                hashIdx = (hashIdx + 1) % HASH_SIZE;
+            m_hashValues[hashIdx].store(static_cast<uint32_t>(slabIdx), std::memory_order_relaxed);
+            m_hashKeys[hashIdx].store(base, std::memory_order_release);
+            m_slabCount.store(slabIdx + 1, std::memory_order_release);
+            // publish all new slots on the global list (in reverse - lowest index on top)
+            const auto first = static_cast<uint32_t>(slabIdx * NODES_PER_SLAB);
+            for (auto idx = static_cast<uint32_t>(NODES_PER_SLAB); idx > 0; idx--)
+                pushGlobal(first + idx - 1);
+            return true;
+        }
+
+    private:
+        /// Unique (never reused) identifier, used as a key for thread-local magazines
+        const uint64_t m_poolId;
+        /// Head of the global free list: ABA tag in the high half, index + 1 in the low half
+        alignas(64) std::atomic<uint64_t> m_freeHead;
+        alignas(64) std::atomic<size_type> m_slabCount;
+        std::mutex m_mutexGrow;
+        std::array<std::atomic<Slab *>, MAX_SLABS> m_slabs;
+        /// Open addressing hash set: slab base address -> slab index
+        std::array<std::atomic<uintptr_t>, HASH_SIZE> m_hashKeys;
+        std::array<std::atomic<uint32_t>, HASH_SIZE> m_hashValues;
+        /// Number of heap allocated objects - the set is not searched while it's zero
+        std::atomic<size_type> m_overflowCount;
+        mutable std::mutex m_mutexOverflow;
+        /// Objects allocated on the heap after the last slab was used up
+        std::unordered_set<const void *> m_overflow;
+    }; //# class SlabPool
+} //> namespace util
+
+#endif //> FG_INC_UTIL_SLAB_POOL
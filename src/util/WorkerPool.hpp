@@ -0,0 +1,262 @@
+#pragma once
+#ifndef FG_INC_UTIL_WORKER_POOL
+#define FG_INC_UTIL_WORKER_POOL
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+    /**
+     * Work stealing thread pool. Every worker has its own task deque - the owner pushes
+     * and pops at the back (LIFO, cache friendly for nested tasks), idle workers steal
+     * from the front of other deques. Tasks are plain function pointers with two user
+     * pointers, so submitting does not allocate (apart from the deque growth).
+     *
+     * Completion is tracked with a WaitGroup - wait() does not block idly, the calling
+     * thread executes pending tasks until all tasks of the group are finished. When the
+     * pool is not running tasks are executed immediately on the calling thread.
+     */
+    class WorkerPool
+    {
+    public:
+        using self_type = WorkerPool;
+        using size_type = std::size_t;
+        using TaskFunction = void (*)(void *context, void *data);
+
+        /**
+         * Counter of the submitted tasks that are not finished yet
+         */
+        class WaitGroup
+        {
+            friend class WorkerPool;
+
+        public:
+            WaitGroup() : m_pending(0) {}
+
+            WaitGroup(const WaitGroup &other) = delete;
+            WaitGroup &operator=(const WaitGroup &other) = delete;
+
+            inline size_type pending(void) const noexcept { return m_pending.load(std::memory_order_acquire); }
+
+            inline bool done(void) const noexcept { return pending() == 0; }
+
+        private:
+            std::atomic<size_type> m_pending;
+        }; //# class WaitGroup
+
+    protected:
+        struct Task
+        {
+            TaskFunction function;
+            void *context;
+            void *data;
+            WaitGroup *group;
+        }; //# struct Task
+
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        }; //# struct WorkerQueue
+
+    public:
+        WorkerPool() : m_queues(),
+                       m_threads(),
+                       m_nextQueue(0),
+                       m_queued(0),
+                       m_running(false),
+                       m_stopRequested(false),
+                       m_mutexWake(),
+                       m_wakeCondition() {}
+
+        ~WorkerPool() { stop(); }
+
+        WorkerPool(const self_type &other) = delete;
+        self_type &operator=(const self_type &other) = delete;
+
+    public:
+        inline bool isRunning(void) const noexcept { return m_running.load(std::memory_order_acquire); }
+
+        /// Number of worker threads
+        inline size_type size(void) const noexcept { return m_threads.size(); }
+
+        /**
+         * Start the worker threads.
+         * @param numWorkers Number of workers, zero - one less than the number of cores
+         *                   (the thread calling wait() takes part in the work too)
+         */
+        bool start(unsigned int numWorkers = 0)
+        {
+            if (isRunning())
+                return false;
+            if (!numWorkers)
+            {
+                const auto cores = std::thread::hardware_concurrency();
+                numWorkers = cores > 1 ? cores - 1 : 1;
+            }
+            m_stopRequested.store(false);
+            m_queues.clear();
+            for (unsigned int idx = 0; idx < numWorkers; idx++)
+                m_queues.emplace_back(new WorkerQueue());
+            try
+            {
+                for (unsigned int idx = 0; idx < numWorkers; idx++)
+                    m_threads.emplace_back(&WorkerPool::workerMain, this, idx);
+            }
+            catch (...)
+            {
+                stop();
+                return false;
+            }
+            m_running.store(true, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Finish all queued tasks and join the worker threads
+         */
+        void stop(void)
+        {
+            /* lock mutex wake */ {
+                const std::lock_guard<std::mutex> lock(m_mutexWake);
+                m_stopRequested.store(true);
+            }
+            m_wakeCondition.notify_all();
+            for (auto &thread : m_threads)
+            {
+                if (thread.joinable())
+                    thread.join();
+            }
+            m_threads.clear();
+            m_running.store(false, std::memory_order_release);
+            // Nothing should be left (workers quit on empty queues), just in case
+            while (tryRun(0))
+                continue;
+        }
+
+        /**
+         * Queue the task: function(context, data). Executed immediately when the pool
+         * is not running.
+         */
+        void submit(WaitGroup &group, TaskFunction function, void *context, void *data)
+        {
+            if (!function)
+                return;
+            if (!isRunning() || m_queues.empty())
+            {
+                function(context, data);
+                return;
+            }
+            group.m_pending.fetch_add(1, std::memory_order_relaxed);
+            // Workers push to their own queue, other threads spread the tasks around
+            size_type queueIdx = 0;
+            if (s_currentPool == this)
+                queueIdx = s_workerIndex;
+            else
+                queueIdx = m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+            /* lock worker queue */ {
+                auto &queue = *m_queues[queueIdx];
+                const std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(Task{function, context, data, &group});
+            }
+            m_queued.fetch_add(1, std::memory_order_release);
+            /* lock mutex wake */ {
+                // empty critical section - a worker checking the predicate can't miss it
+                const std::lock_guard<std::mutex> lock(m_mutexWake);
+            }
+            m_wakeCondition.notify_one();
+        }
+
+        /**
+         * Join - execute pending tasks on the calling thread until every task from the
+         * group is finished.
+         */
+        void wait(WaitGroup &group)
+        {
+            const size_type preferred = s_currentPool == this ? s_workerIndex : 0;
+            while (!group.done())
+            {
+                if (!tryRun(preferred))
+                    std::this_thread::yield(); // remaining tasks are being executed
+            }
+        }
+
+    protected:
+        /**
+         * Pop a task from the preferred queue (back) or steal from the others (front)
+         * and execute it.
+         * @return False if there was nothing to execute
+         */
+        bool tryRun(size_type preferred)
+        {
+            if (m_queued.load(std::memory_order_acquire) == 0 || m_queues.empty())
+                return false;
+            Task task{nullptr, nullptr, nullptr, nullptr};
+            const auto numQueues = m_queues.size();
+            for (size_type offset = 0; offset < numQueues && !task.function; offset++)
+            {
+                auto &queue = *m_queues[(preferred + offset) % numQueues];
+                const std::lock_guard<std::mutex> lock(queue.mutex);
+                if (queue.tasks.empty())
+                    continue;
+                if (offset == 0)
+                {
+                    task = queue.tasks.back();
+                    queue.tasks.pop_back();
+                }
+                else
+                {
+                    task = queue.tasks.front();
+                    queue.tasks.pop_front();
+                }
+            } //# for each worker queue
+            if (!task.function)
+                return false;
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            task.function(task.context, task.data);
+            task.group->m_pending.fetch_sub(1, std::memory_order_release);
+            return true;
+        }
+
+        void workerMain(size_type index)
+        {
+            s_currentPool = this;
+            s_workerIndex = index;
+            while (true)
+            {
+                if (tryRun(index))
+                    continue;
+                std::unique_lock<std::mutex> lock(m_mutexWake);
+                m_wakeCondition.wait(lock, [this]()
+                                     { return m_stopRequested.load() || m_queued.load() > 0; });
+                if (m_stopRequested.load() && m_queued.load() == 0)
+                    break;
+            }
+            s_currentPool = nullptr;
+        }
+
+    private:
+        /// Pool owning the current worker thread (null on other threads)
+        inline static thread_local const WorkerPool *s_currentPool = nullptr;
+        inline static thread_local size_type s_workerIndex = 0;
+
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+        std::vector<std::thread> m_threads;
+        /// Round robin counter for tasks submitted from outside of the pool
+        std::atomic<size_type> m_nextQueue;
+        /// Number of tasks waiting in all queues
+        std::atomic<size_type> m_queued;
+        std::atomic_bool m_running;
+        std::atomic_bool m_stopRequested;
+        std::mutex m_mutexWake;
+        std::condition_variable m_wakeCondition;
+    }; //# class WorkerPool
+} //> namespace util
+
+#endif //> FG_INC_UTIL_WORKER_POOL
@@ -108,3 +108,37 @@ void timesys::sleep(unsigned int ms)
 #endif
 }
 //>---------------------------------------------------------------------------------------
+
+#if defined(FG_USING_PLATFORM_LINUX) || defined(FG_USING_PLATFORM_ANDROID)
+#include <time.h>
+#include <cerrno>
+#else
+#include <thread>
+#endif
+void timesys::sleepUntil(int64_t timeStamp)
+{
+    // ticks() has no fixed epoch (SDL_GetTicks counts from init, otherwise it's the wall
+    // clock that can jump) - the remaining time is measured on the same clock and slept
+    // on the monotonic one
+    const int64_t remaining = timeStamp - ticks();
+    if (remaining <= 0)
+        return;
+#if defined(FG_USING_PLATFORM_LINUX) || defined(FG_USING_PLATFORM_ANDROID)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += static_cast<time_t>(remaining / 1000);
+    ts.tv_nsec += static_cast<long>(remaining % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    // absolute deadline - interrupted sleeps don't drift
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+    {
+    };
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(remaining));
+#endif
+}
+//>---------------------------------------------------------------------------------------
@@ -62,6 +62,14 @@ namespace timesys
      */
     int64_t seconds(void);
     void sleep(unsigned int ms);
+    /**
+     * Sleep until the given point in time (milliseconds, same base as ticks()). The
+     * remaining time is converted into an absolute CLOCK_MONOTONIC deadline on POSIX
+     * systems (clock_nanosleep with TIMER_ABSTIME), so wall clock changes don't affect
+     * it and interrupted sleeps don't drift.
+     * @param timeStamp
+     */
+    void sleepUntil(int64_t timeStamp);
 } //> namespace timesys
 
 #endif //> FG_INC_TIMESYS
\ No newline at end of file
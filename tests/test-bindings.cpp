@@ -1,6 +1,7 @@
 #include <catch2/catch.hpp>
 #include <util/Tag.hpp>
 #include <util/Bindings.hpp>
+#include <util/InlineArgs.hpp>
 #include <resource/ManagedObject.hpp>
 //>---------------------------------------------------------------------------------------
 
@@ -97,4 +98,37 @@ TEST_CASE("Create complete metadata bindings", "[bindings]")
 TEST_CASE("Invoke bindings from metadata", "[bindings]")
 {
 }
-//!---------------------------------------------------------------------------------------
\ No newline at end of file
+//!---------------------------------------------------------------------------------------
+TEST_CASE("Inline argument storage", "[bindings]")
+{
+    util::InlineArgs<3> args;
+    args.push(util::WrappedValue::wrapInPlace(10));
+    args.push(util::WrappedValue::wrapInPlace(2.5f));
+    args.push(util::WrappedValue::wrapInPlace("text"));
+    REQUIRE(args.spilled() == 0);
+    args.push(util::WrappedValue::wrapInPlace(7)); // spills to heap
+    REQUIRE(args.size() == 4);
+    REQUIRE(args.spilled() == 1);
+
+    util::InlineArgs<3> moved(std::move(args));
+    REQUIRE(args.empty());
+    REQUIRE(moved[0]->get<int>() == 10);
+    REQUIRE(moved[1]->get<float>() == 2.5f);
+    REQUIRE(moved[2]->get<std::string>() == "text");
+    REQUIRE(moved[3]->get<int>() == 7);
+    // already wrapped values are copied, not wrapped as an external pointer
+    util::WrappedValue wrapped = util::WrappedValue::wrapInPlace(42);
+    auto copied = util::WrappedValue::wrapInPlace(&wrapped);
+    REQUIRE(!copied.isExternal());
+    REQUIRE(copied.get<int>() == 42);
+    {
+        util::ArgsView view(moved);
+        REQUIRE(view.get().size() == 4);
+        REQUIRE(view.get()[0] == moved[0]);
+        util::ArgsView nested(moved);
+        REQUIRE(&nested.get() != &view.get());
+    }
+    moved.reset();
+    REQUIRE(moved.empty());
+}
+//!---------------------------------------------------------------------------------------
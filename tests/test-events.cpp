@@ -1,8 +1,18 @@
 #include <catch2/catch.hpp>
 
 #include <event/EventManager.hpp>
+#include <event/EventBatch.hpp>
+#include <event/EventRecorder.hpp>
+#include <event/Signal.hpp>
+#include <event/EventAwait.hpp>
+#include <event/EventBridge.hpp>
 #include <resource/GlobalObjectRegistry.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 event::EventManager *g_eventMgr = nullptr;
 
 event::EventManager *initializeEventManager(void)
@@ -69,4 +79,827 @@ TEST_CASE("Trigger events in fake loop", "[events]")
     auto pEventMgr = initializeEventManager();
     destroyEventManager();
 }
-//!---------------------------------------------------------------------------------------
\ No newline at end of file
+//!---------------------------------------------------------------------------------------
+TEST_CASE("Dispatch table with standard and custom event codes", "[events]")
+{
+    event::DispatchTable<int> table;
+    REQUIRE(table.find(event::Type::ProgramInit) != nullptr); // standard range is preallocated
+    REQUIRE(table.find(static_cast<event::Type>(5000)) == nullptr);
+    table[event::Type::ProgramInit] = 1;
+    table[static_cast<event::Type>(5000)] = 2;
+    table[static_cast<event::Type>(event::DispatchTable<int>::MAX_DENSE_CODES + 10)] = 3;
+    REQUIRE(*table.find(static_cast<event::Type>(5000)) == 2);
+    int sum = 0, count = 0;
+    table.forEach([&](event::Type eventCode, int &value)
+                  {
+        sum += value;
+        count++;
+        return false; });
+    REQUIRE(count == 3);
+    REQUIRE(sum == 6);
+    table.clear();
+    REQUIRE(*table.find(event::Type::ProgramInit) == 0);
+}
+//!---------------------------------------------------------------------------------------
+
+static int g_selfRemovingCalls = 0;
+
+bool SelfRemovingCallback(void)
+{
+    g_selfRemovingCalls++;
+    // callback is deleted while the dispatch is still iterating the snapshot
+    g_eventMgr->deleteCallbacks(event::Type::CustomEvent);
+    return true;
+}
+
+bool CountingCallback(void)
+{
+    g_selfRemovingCalls++;
+    return true;
+}
+
+TEST_CASE("Delete callbacks during dispatch", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(pEventMgr->addCallback(event::Type::CustomEvent, &SelfRemovingCallback) != nullptr);
+    REQUIRE(pEventMgr->addCallback(event::Type::CustomEvent, &CountingCallback) != nullptr);
+    // snapshot taken at the start of the dispatch is used until the end
+    REQUIRE(pEventMgr->executeEvent(event::Type::CustomEvent) == 2);
+    REQUIRE(g_selfRemovingCalls == 2);
+    REQUIRE(pEventMgr->executeEvent(event::Type::CustomEvent) == 0);
+    REQUIRE(pEventMgr->isRegistered(&CountingCallback) == event::Type::Invalid);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static int g_motionCalls = 0;
+static int g_motionRelX = 0;
+
+bool MotionCallback(event::EventCombined *event)
+{
+    g_motionCalls++;
+    g_motionRelX = event->mouse.relX;
+    return true;
+}
+
+TEST_CASE("Coalesce mouse motion events", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(pEventMgr->addCallback(event::Type::MouseMotion, &MotionCallback) != nullptr);
+    pEventMgr->setCoalescePolicy(event::Type::MouseMotion, event::CoalescePolicy::AccumulateDeltas);
+    REQUIRE(pEventMgr->getCoalescePolicy(event::Type::MouseMotion) == event::CoalescePolicy::AccumulateDeltas);
+    for (int i = 0; i < 3; i++)
+    {
+        auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::MouseMotion));
+        pEvent->mouse.pointerID = 0;
+        pEvent->mouse.pressed = false;
+        pEvent->mouse.relX = 2;
+        pEvent->mouse.relY = 0;
+        pEventMgr->throwEvent(event::Type::MouseMotion, pEvent);
+    }
+    pEventMgr->processEvents();
+    REQUIRE(g_motionCalls == 1);
+    REQUIRE(g_motionRelX == 6);
+    REQUIRE(pEventMgr->getCoalescedCount(event::Type::MouseMotion) == 2);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static std::vector<int> g_motionPointers;
+
+bool MotionPointerCallback(event::EventCombined *event)
+{
+    g_motionPointers.push_back(event->mouse.pointerID);
+    return true;
+}
+
+TEST_CASE("Coalesced events of different pointers keep the throw order", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(pEventMgr->addCallback(event::Type::MouseMotion, &MotionPointerCallback) != nullptr);
+    pEventMgr->setCoalescePolicy(event::Type::MouseMotion, event::CoalescePolicy::KeepLatest);
+    for (int pointerID : {0, 1, 0, 0})
+    {
+        auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::MouseMotion));
+        pEvent->mouse.pointerID = pointerID;
+        pEvent->mouse.pressed = false;
+        pEventMgr->throwEvent(event::Type::MouseMotion, pEvent);
+    }
+    pEventMgr->processEvents();
+    // merged only into the latest pending event - the last two are merged
+    REQUIRE(g_motionPointers == std::vector<int>{0, 1, 0});
+    REQUIRE(pEventMgr->getCoalescedCount(event::Type::MouseMotion) == 1);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static std::vector<event::Type> g_dispatchOrder;
+
+bool RecordLowCallback(void)
+{
+    g_dispatchOrder.push_back(event::Type::ResourceCreated);
+    return true;
+}
+
+bool RecordHighCallback(void)
+{
+    g_dispatchOrder.push_back(event::Type::KeyDown);
+    return true;
+}
+
+TEST_CASE("Priority lanes and events budget", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(pEventMgr->setEventLane(event::Type::ResourceCreated, event::EventLane::Low));
+    REQUIRE(pEventMgr->setEventLane(event::Type::KeyDown, event::EventLane::High));
+    REQUIRE(pEventMgr->getEventLane(event::Type::ProgramInit) == event::EventLane::Normal);
+    pEventMgr->addCallback(event::Type::ResourceCreated, &RecordLowCallback);
+    pEventMgr->addCallback(event::Type::KeyDown, &RecordHighCallback);
+    pEventMgr->setEventsBudget(2);
+    pEventMgr->throwEvent(event::Type::ResourceCreated);
+    pEventMgr->throwEvent(event::Type::ResourceCreated);
+    pEventMgr->throwEvent(event::Type::KeyDown);
+    pEventMgr->processEvents();
+    REQUIRE(g_dispatchOrder.size() == 2);
+    REQUIRE(g_dispatchOrder[0] == event::Type::KeyDown);
+    REQUIRE(pEventMgr->getLaneStats(event::EventLane::Low).depth == 1);
+    REQUIRE(pEventMgr->getLaneStats(event::EventLane::Low).carriedOver == 1);
+    pEventMgr->processEvents();
+    REQUIRE(g_dispatchOrder.size() == 3);
+    REQUIRE(pEventMgr->getLaneStats(event::EventLane::Low).depth == 0);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static std::atomic<int> g_parallelCalls(0);
+
+bool ParallelCallback(void)
+{
+    g_parallelCalls++;
+    return true;
+}
+
+TEST_CASE("Parallel handlers are joined before executeEvent returns", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(pEventMgr->startWorkerPool(2));
+    for (int idx = 0; idx < 8; idx++)
+        REQUIRE(pEventMgr->addCallback(event::Type::UpdateShot, &ParallelCallback, true) != nullptr);
+    REQUIRE(pEventMgr->addCallback(event::Type::UpdateShot, &CountingCallback) != nullptr);
+    for (int round = 0; round < 10; round++)
+        REQUIRE(pEventMgr->executeEvent(event::Type::UpdateShot) == 9);
+    REQUIRE(g_parallelCalls.load() == 80);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static int g_touchCalls = 0;
+static int g_touchSum = 0;
+
+bool TouchCallback(event::EventCombined *event)
+{
+    g_touchCalls++;
+    g_touchSum += event->touch.x;
+    return true;
+}
+
+TEST_CASE("Throw events in a batch", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(pEventMgr->addCallback(event::Type::TouchMotion, &TouchCallback) != nullptr);
+    event::EventBatch batch(pEventMgr, 16);
+    auto &structs = batch.emplace(event::Type::TouchMotion, 10);
+    REQUIRE(structs.size() == 10);
+    for (int idx = 0; idx < 10; idx++)
+        structs[idx]->touch.x = idx;
+    batch.emplace(event::Type::TouchMotion)->touch.x = 100;
+    REQUIRE(batch.size() == 11);
+    REQUIRE(batch.commit());
+    REQUIRE(batch.empty());
+    pEventMgr->processEvents();
+    REQUIRE(g_touchCalls == 11);
+    REQUIRE(g_touchSum == 145);
+    // not committed - structures go back to the pool
+    batch.emplace(event::Type::TouchMotion, 4);
+    batch.discard();
+    pEventMgr->processEvents();
+    REQUIRE(g_touchCalls == 11);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static int g_replayedX = 0;
+static int g_replayedCalls = 0;
+
+bool ReplayCallback(event::EventCombined *event)
+{
+    g_replayedCalls++;
+    g_replayedX += event->touch.x;
+    return true;
+}
+
+TEST_CASE("Record and replay thrown events", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    event::EventRecorder recorder;
+    recorder.start();
+    pEventMgr->setRecorder(&recorder);
+    for (int idx = 1; idx <= 3; idx++)
+    {
+        auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::TouchPressed));
+        pEvent->touch.x = idx * 10;
+        pEventMgr->throwEvent(event::Type::TouchPressed, pEvent);
+    }
+    pEventMgr->setRecorder(nullptr);
+    recorder.stop();
+    REQUIRE(recorder.count() == 3);
+    pEventMgr->processEvents(); // no callbacks yet - recorded traffic is dropped
+    REQUIRE(pEventMgr->addCallback(event::Type::TouchPressed, &ReplayCallback) != nullptr);
+    event::EventReplayer replayer;
+    REQUIRE(replayer.load(recorder.data()));
+    replayer.start(0.0); // no delays
+    REQUIRE(replayer.update(*pEventMgr) == 3);
+    REQUIRE(replayer.isFinished());
+    pEventMgr->processEvents();
+    REQUIRE(g_replayedCalls == 3);
+    REQUIRE(g_replayedX == 60);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static int g_measuredCalls = 0;
+
+bool MeasuredCallback(event::EventCombined *event)
+{
+    g_measuredCalls++;
+    return true;
+}
+
+TEST_CASE("Per type dispatch metrics", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(pEventMgr->addCallback(event::Type::KeyDown, &MeasuredCallback) != nullptr);
+    REQUIRE(pEventMgr->addCallback(event::Type::KeyDown, &MeasuredCallback) != nullptr);
+    pEventMgr->throwEvent(event::Type::KeyDown);
+    pEventMgr->processEvents();
+    REQUIRE(pEventMgr->getEventMetrics(event::Type::KeyDown) == nullptr); // disabled by default
+    pEventMgr->setMetricsEnabled(true);
+    for (int idx = 0; idx < 5; idx++)
+        pEventMgr->throwEvent(event::Type::KeyDown);
+    pEventMgr->processEvents();
+    auto pMetrics = pEventMgr->getEventMetrics(event::Type::KeyDown);
+    REQUIRE(pMetrics != nullptr);
+    REQUIRE(pMetrics->thrown == 5);
+    REQUIRE(pMetrics->dispatched == 5);
+    REQUIRE(pMetrics->callbacks == 10);
+    REQUIRE(pMetrics->queueWait.count() == 5);
+    REQUIRE(pMetrics->dispatchTime.count() == 5);
+    REQUIRE(pMetrics->callbackTime.count() == 10);
+    REQUIRE(pMetrics->slowestCallback != nullptr);
+    REQUIRE(pEventMgr->getMeasuredEventTypes().size() == 1);
+    pEventMgr->resetEventMetrics();
+    REQUIRE(pMetrics->thrown == 0);
+    REQUIRE(pMetrics->callbackTime.count() == 0);
+    pEventMgr->setMetricsEnabled(false);
+    REQUIRE(g_measuredCalls == 12);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static int g_typedCalls = 0;
+static int g_dynamicCalls = 0;
+
+bool TypedTouchHandler(event::EventCombined *event)
+{
+    g_typedCalls++;
+    return true;
+}
+
+struct TypedTouchListener
+{
+    int calls = 0;
+    void onTouch(event::EventCombined *event) { calls += event ? 1 : 0; }
+};
+
+bool DynamicTouchCallback(event::EventCombined *event)
+{
+    g_dynamicCalls++;
+    return true;
+}
+
+TEST_CASE("Typed signals call handlers directly and reach dynamic callbacks", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    event::Signal<event::EventCombined *> touchSignal(pEventMgr, event::Type::TouchPressed);
+    TypedTouchListener listener;
+    REQUIRE(touchSignal.connect(&TypedTouchHandler) != 0);
+    const auto listenerId = touchSignal.connect<&TypedTouchListener::onTouch>(&listener);
+    REQUIRE(touchSignal.size() == 2);
+    auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::TouchPressed));
+    REQUIRE(touchSignal.emit(pEvent) == 2);
+    REQUIRE(g_typedCalls == 1);
+    REQUIRE(listener.calls == 1);
+    // dynamic subscribers (scripts) receive the emitted arguments too
+    REQUIRE(pEventMgr->addCallback(event::Type::TouchPressed, &DynamicTouchCallback) != nullptr);
+    REQUIRE(touchSignal.emit(pEvent) == 3);
+    REQUIRE(g_dynamicCalls == 1);
+    // bridge - thrown events reach the typed handlers, emit does not call them twice
+    REQUIRE(touchSignal.attach());
+    REQUIRE(touchSignal.disconnect(listenerId));
+    REQUIRE(touchSignal.emit(pEvent) == 2);
+    REQUIRE(g_typedCalls == 3);
+    pEventMgr->throwEvent(event::Type::TouchPressed, pEvent); // released after dispatch
+    pEventMgr->processEvents();
+    REQUIRE(g_typedCalls == 4);
+    REQUIRE(g_dynamicCalls == 3);
+    touchSignal.detach();
+    REQUIRE(!touchSignal.isAttached());
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static std::atomic<int> g_parallelTypedCalls(0);
+
+bool ParallelTypedHandler(event::EventCombined *event)
+{
+    g_parallelTypedCalls++;
+    return true;
+}
+
+TEST_CASE("Typed signal handlers run once with parallel dispatch", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(pEventMgr->startWorkerPool(2));
+    REQUIRE(pEventMgr->setParallelDispatch(event::Type::TouchReleased, true));
+    event::Signal<event::EventCombined *> touchSignal(pEventMgr, event::Type::TouchReleased);
+    REQUIRE(touchSignal.connect(&ParallelTypedHandler) != 0);
+    REQUIRE(touchSignal.attach());
+    REQUIRE(pEventMgr->addCallback(event::Type::TouchReleased, &ParallelCallback) != nullptr);
+    auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::TouchReleased));
+    g_parallelCalls = 0;
+    // the bridge runs on the worker pool - it's skipped by identity, not by thread
+    for (int round = 0; round < 10; round++)
+        REQUIRE(touchSignal.emit(pEvent) == 2);
+    REQUIRE(g_parallelTypedCalls.load() == 10);
+    REQUIRE(g_parallelCalls.load() == 10);
+    touchSignal.detach();
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static int g_keyACalls = 0;
+static int g_keyBCalls = 0;
+static int g_anyKeyCalls = 0;
+
+bool KeyACallback(event::EventCombined *event)
+{
+    g_keyACalls++;
+    return true;
+}
+
+bool KeyBCallback(event::EventCombined *event)
+{
+    g_keyBCalls++;
+    return true;
+}
+
+bool AnyKeyCallback(event::EventCombined *event)
+{
+    g_anyKeyCalls++;
+    return true;
+}
+
+TEST_CASE("Filtered callbacks receive only matching events", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    auto pCallbackA = pEventMgr->addCallback(event::Type::KeyDown, &KeyACallback, event::EventFilter::keyCode(event::KeyCode::A));
+    REQUIRE(pCallbackA != nullptr);
+    REQUIRE(pEventMgr->addCallback(event::Type::KeyDown, &KeyBCallback, event::EventFilter::keyCode(event::KeyCode::B)) != nullptr);
+    REQUIRE(pEventMgr->addCallback(event::Type::KeyDown, &AnyKeyCallback) != nullptr);
+    // duplicate for the same key and filters on events without a key are rejected
+    REQUIRE(pEventMgr->addCallback(pCallbackA, event::Type::KeyDown, event::EventFilter::keyCode(event::KeyCode::A)) == nullptr);
+    REQUIRE(pEventMgr->addCallback(event::Type::ProgramQuit, &AnyKeyCallback, event::EventFilter::keyCode(event::KeyCode::A)) == nullptr);
+    REQUIRE(pEventMgr->getCallbacksCount(event::Type::KeyDown) == 3);
+    auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::KeyDown));
+    pEvent->key.keyCode = event::KeyCode::A;
+    pEventMgr->throwEvent(event::Type::KeyDown, pEvent);
+    pEventMgr->processEvents();
+    REQUIRE(g_keyACalls == 1);
+    REQUIRE(g_keyBCalls == 0);
+    REQUIRE(g_anyKeyCalls == 1);
+    REQUIRE(pEventMgr->isRegisteredCallback(event::Type::KeyDown, pCallbackA));
+    REQUIRE(pEventMgr->removeCallback(event::Type::KeyDown, pCallbackA));
+    pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::KeyDown));
+    pEvent->key.keyCode = event::KeyCode::A;
+    pEventMgr->throwEvent(event::Type::KeyDown, pEvent);
+    pEventMgr->processEvents();
+    REQUIRE(g_keyACalls == 1);
+    REQUIRE(g_anyKeyCalls == 2);
+    delete pCallbackA;
+    REQUIRE(pEventMgr->deleteCallbacks(event::Type::KeyDown) == 2);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static int g_saveCalls = 0;
+static int g_plainSCalls = 0;
+
+bool SaveShortcutCallback(event::EventCombined *event)
+{
+    g_saveCalls++;
+    return true;
+}
+
+bool PlainKeySCallback(event::EventCombined *event)
+{
+    g_plainSCalls++;
+    return true;
+}
+
+void ThrowKeyDown(event::EventManager *pEventMgr, event::KeyCode keyCode, event::KeyMod mod)
+{
+    auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::KeyDown));
+    pEvent->key.keyCode = keyCode;
+    pEvent->key.mod = mod;
+    pEventMgr->throwEvent(event::Type::KeyDown, pEvent);
+    pEventMgr->processEvents();
+}
+
+TEST_CASE("Key combination bindings", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    auto pSave = pEventMgr->bindKey(event::KeyCode::S, event::KeyMod::LCTRL, &SaveShortcutCallback);
+    REQUIRE(pSave != nullptr);
+    REQUIRE(pEventMgr->bindKey(event::KeyCode::S, event::KeyMod::NONE, &PlainKeySCallback) != nullptr);
+    REQUIRE(pEventMgr->bindKey(pSave, event::KeyCode::S, event::KeyMod::RCTRL) == nullptr); // same combination
+    REQUIRE(pEventMgr->bindKey(pSave, event::KeyCode::S, event::KeyMod::NONE, event::Type::MouseMotion) == nullptr);
+    REQUIRE(pEventMgr->isKeyBound(event::KeyCode::S, event::KeyMod::RCTRL));
+    REQUIRE(!pEventMgr->isKeyBound(event::KeyCode::S, event::KeyMod::LALT));
+    ThrowKeyDown(pEventMgr, event::KeyCode::S, event::KeyMod::RCTRL | event::KeyMod::NUM);
+    REQUIRE(g_saveCalls == 1);
+    REQUIRE(g_plainSCalls == 0);
+    ThrowKeyDown(pEventMgr, event::KeyCode::S, event::KeyMod::CAPS);
+    ThrowKeyDown(pEventMgr, event::KeyCode::S, event::KeyMod::LCTRL | event::KeyMod::LSHIFT);
+    ThrowKeyDown(pEventMgr, event::KeyCode::D, event::KeyMod::LCTRL);
+    REQUIRE(g_saveCalls == 1);
+    REQUIRE(g_plainSCalls == 1);
+    REQUIRE(pEventMgr->unbindKey(pSave, event::KeyCode::S, event::KeyMod::LCTRL));
+    ThrowKeyDown(pEventMgr, event::KeyCode::S, event::KeyMod::LCTRL);
+    REQUIRE(g_saveCalls == 1);
+    delete pSave;
+    REQUIRE(pEventMgr->deleteKeyBindings() == 1);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static std::vector<std::pair<unsigned int, int>> g_stagedEvents;
+
+bool StagedTouchCallback(event::EventCombined *event)
+{
+    g_stagedEvents.emplace_back(event->touch.touchID, event->touch.x);
+    return true;
+}
+
+TEST_CASE("Thread staging keeps per thread order", "[events]")
+{
+    const int numThreads = 4;
+    const int numEvents = 500;
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(pEventMgr->addCallback(event::Type::TouchMotion, &StagedTouchCallback) != nullptr);
+    pEventMgr->setThreadStaging(true);
+    REQUIRE(pEventMgr->isThreadStaging());
+    std::vector<std::thread> producers;
+    for (int idx = 0; idx < numThreads; idx++)
+    {
+        producers.emplace_back([pEventMgr, idx]()
+                               {
+            for (int seq = 0; seq < numEvents; seq++)
+            {
+                auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::TouchMotion));
+                pEvent->touch.touchID = static_cast<unsigned int>(idx);
+                pEvent->touch.x = seq;
+                pEventMgr->throwEvent(event::Type::TouchMotion, pEvent);
+            } });
+    }
+    for (auto &producer : producers)
+        producer.join();
+    pEventMgr->processEvents();
+    REQUIRE(g_stagedEvents.size() == numThreads * numEvents);
+    std::vector<int> last(numThreads, -1);
+    for (auto &it : g_stagedEvents)
+    {
+        REQUIRE(it.second == last[it.first] + 1);
+        last[it.first] = it.second;
+    }
+    // staged events are released on destroy
+    auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::TouchMotion));
+    pEventMgr->throwEvent(event::Type::TouchMotion, pEvent);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+TEST_CASE("Idle staging buffers of finished threads are released", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    g_stagedEvents.clear();
+    REQUIRE(pEventMgr->addCallback(event::Type::TouchMotion, &StagedTouchCallback) != nullptr);
+    pEventMgr->setThreadStaging(true);
+    for (int idx = 0; idx < 8; idx++)
+    {
+        std::thread producer([pEventMgr, idx]()
+                             {
+            auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::TouchMotion));
+            pEvent->touch.touchID = static_cast<unsigned int>(idx);
+            pEvent->touch.x = 0;
+            pEventMgr->throwEvent(event::Type::TouchMotion, pEvent); });
+        producer.join();
+    }
+    REQUIRE(pEventMgr->getStagingBuffersCount() == 8);
+    for (unsigned int frame = 0; frame <= event::EventManager::STAGING_IDLE_FRAMES; frame++)
+        pEventMgr->processEvents();
+    REQUIRE(g_stagedEvents.size() == 8);
+    REQUIRE(pEventMgr->getStagingBuffersCount() == 0);
+    // a thread whose buffer was retired gets a new one
+    pEventMgr->throwEvent(event::Type::TouchMotion, pEventMgr->requestEventStruct(event::Type::TouchMotion));
+    REQUIRE(pEventMgr->getStagingBuffersCount() == 1);
+    for (unsigned int frame = 0; frame <= event::EventManager::STAGING_IDLE_FRAMES; frame++)
+        pEventMgr->processEvents();
+    REQUIRE(pEventMgr->getStagingBuffersCount() == 0);
+    pEventMgr->throwEvent(event::Type::TouchMotion, pEventMgr->requestEventStruct(event::Type::TouchMotion));
+    pEventMgr->processEvents();
+    REQUIRE(g_stagedEvents.size() == 10);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+#if defined(FG_EVENT_COROUTINES)
+static int g_flowStep = 0;
+static int g_flowTouchX = 0;
+
+event::Task TouchThenSleepFlow(event::EventManager *pEventMgr)
+{
+    g_flowStep = 1;
+    auto pEvent = co_await event::nextEvent(pEventMgr, event::Type::TouchPressed);
+    g_flowTouchX = pEvent ? pEvent->touch.x : -1;
+    g_flowStep = 2;
+    co_await event::sleepFor(pEventMgr, 10);
+    g_flowStep = 3;
+}
+
+TEST_CASE("Coroutines resume on events and deadlines", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    TouchThenSleepFlow(pEventMgr);
+    REQUIRE(g_flowStep == 1);
+    pEventMgr->processEventsAndTimers();
+    REQUIRE(g_flowStep == 1);
+    auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::TouchPressed));
+    pEvent->touch.x = 42;
+    pEventMgr->throwEvent(event::Type::TouchPressed, pEvent);
+    pEventMgr->processEventsAndTimers();
+    REQUIRE(g_flowStep == 2);
+    REQUIRE(g_flowTouchX == 42);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pEventMgr->processEventsAndTimers();
+    REQUIRE(g_flowStep == 3);
+    // suspended coroutines are destroyed with the manager
+    TouchThenSleepFlow(pEventMgr);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+#endif
+
+#if defined(FG_USING_PLATFORM_LINUX)
+static int g_bridgedCalls = 0;
+static int g_bridgedX = 0;
+
+bool BridgedTouchCallback(event::EventCombined *event)
+{
+    g_bridgedCalls++;
+    g_bridgedX = event->touch.x;
+    return true;
+}
+
+static int g_bridgedMenus = 0;
+static bool g_bridgedMenuNames = true;
+
+bool BridgedMenuCallback(event::EventCombined *event)
+{
+    g_bridgedMenus++;
+    g_bridgedMenuNames = event->menuChanged.prevMenuName || event->menuChanged.nextMenuName;
+    return true;
+}
+
+TEST_CASE("Shared memory bridge forwards events between managers", "[events]")
+{
+    auto pLocalMgr = initializeEventManager();
+    auto pRemoteMgr = new event::EventManager();
+    REQUIRE(pRemoteMgr->initialize());
+    event::EventBridge localBridge(pLocalMgr);
+    event::EventBridge remoteBridge(pRemoteMgr);
+    REQUIRE(localBridge.open("test-local", 16));
+    REQUIRE(remoteBridge.open("test-remote", 16));
+    REQUIRE(localBridge.connect("test-remote"));
+    REQUIRE(remoteBridge.connect("test-local"));
+    REQUIRE(localBridge.forward(event::Type::TouchPressed));
+    REQUIRE(remoteBridge.forward(event::Type::TouchPressed));
+    REQUIRE(pRemoteMgr->addCallback(event::Type::TouchPressed, &BridgedTouchCallback) != nullptr);
+    auto pEvent = reinterpret_cast<event::EventCombined *>(pLocalMgr->requestEventStruct(event::Type::TouchPressed));
+    pEvent->touch.x = 7;
+    pLocalMgr->throwEvent(event::Type::TouchPressed, pEvent);
+    pLocalMgr->processEvents();
+    REQUIRE(localBridge.sentCount() == 1);
+    REQUIRE(remoteBridge.wait(100));
+    REQUIRE(remoteBridge.pump() == 1);
+    pRemoteMgr->processEvents();
+    REQUIRE(g_bridgedCalls == 1);
+    REQUIRE(g_bridgedX == 7);
+    // received events are not sent back
+    REQUIRE(remoteBridge.sentCount() == 0);
+    REQUIRE(localBridge.pump() == 0);
+    // slots with unknown codes are discarded
+    event::EventCombined unknown(static_cast<event::Type>(5000));
+    REQUIRE(localBridge.send(unknown) == 1);
+    REQUIRE(remoteBridge.pump() == 0);
+    REQUIRE(remoteBridge.rejectedCount() == 1);
+    // pointers are not valid in the other process - the peer receives null
+    REQUIRE(localBridge.forward(event::Type::MenuChanged));
+    REQUIRE(pRemoteMgr->addCallback(event::Type::MenuChanged, &BridgedMenuCallback) != nullptr);
+    pEvent = reinterpret_cast<event::EventCombined *>(pLocalMgr->requestEventStruct(event::Type::MenuChanged));
+    pEvent->menuChanged.prevMenuName = "main";
+    pEvent->menuChanged.nextMenuName = "options";
+    pEvent->menuChanged.didChange = true;
+    pLocalMgr->throwEvent(event::Type::MenuChanged, pEvent);
+    pLocalMgr->processEvents();
+    REQUIRE(remoteBridge.pump() == 1);
+    pRemoteMgr->processEvents();
+    REQUIRE(g_bridgedMenus == 1);
+    REQUIRE_FALSE(g_bridgedMenuNames);
+    localBridge.close();
+    remoteBridge.close();
+    delete pRemoteMgr;
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+#endif
+
+static std::vector<int> g_limitedX;
+
+bool LimitedTouchCallback(event::EventCombined *event)
+{
+    g_limitedX.push_back(event->touch.x);
+    return true;
+}
+
+bool ThrowTouchMotion(event::EventManager *pEventMgr, int x)
+{
+    auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::TouchMotion));
+    pEvent->touch.x = x;
+    return pEventMgr->throwEvent(event::Type::TouchMotion, pEvent);
+}
+
+TEST_CASE("Lane capacity with overflow policies", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(pEventMgr->addCallback(event::Type::TouchMotion, &LimitedTouchCallback) != nullptr);
+    REQUIRE(pEventMgr->setEventLane(event::Type::TouchMotion, event::EventLane::Low));
+    // drop oldest - only the most recent events survive a stalled consumer
+    pEventMgr->setLaneCapacity(event::EventLane::Low, 4, event::OverflowPolicy::DropOldest);
+    for (int x = 0; x < 10; x++)
+        ThrowTouchMotion(pEventMgr, x);
+    auto stats = pEventMgr->getLaneOverflow(event::EventLane::Low);
+    REQUIRE(stats.capacity == 4);
+    REQUIRE(stats.queued == 4);
+    REQUIRE(stats.dropped == 6);
+    pEventMgr->processEvents();
+    REQUIRE(g_limitedX == std::vector<int>{6, 7, 8, 9});
+    // drop newest
+    g_limitedX.clear();
+    pEventMgr->setLaneCapacity(event::EventLane::Low, 2, event::OverflowPolicy::DropNewest);
+    for (int x = 0; x < 5; x++)
+        ThrowTouchMotion(pEventMgr, x);
+    pEventMgr->processEvents();
+    REQUIRE(g_limitedX == std::vector<int>{0, 1});
+    REQUIRE(pEventMgr->getLaneOverflow(event::EventLane::Low).dropped == 9);
+    // coalesce - the newest event replaces the pending one of the same type
+    g_limitedX.clear();
+    pEventMgr->setLaneCapacity(event::EventLane::Low, 1, event::OverflowPolicy::Coalesce);
+    for (int x = 0; x < 5; x++)
+        ThrowTouchMotion(pEventMgr, x);
+    pEventMgr->processEvents();
+    REQUIRE(g_limitedX == std::vector<int>{4});
+    REQUIRE(pEventMgr->getLaneOverflow(event::EventLane::Low).coalesced == 4);
+    // block - the producer waits until the consumer makes space
+    g_limitedX.clear();
+    pEventMgr->setLaneCapacity(event::EventLane::Low, 1, event::OverflowPolicy::Block, 5000);
+    ThrowTouchMotion(pEventMgr, 1);
+    std::thread producer([pEventMgr]()
+                         { ThrowTouchMotion(pEventMgr, 2); });
+    while (pEventMgr->getLaneOverflow(event::EventLane::Low).blocked == 0)
+        std::this_thread::yield();
+    pEventMgr->processEvents();
+    producer.join();
+    pEventMgr->processEvents();
+    REQUIRE(g_limitedX == std::vector<int>{1, 2});
+    // block on the processing thread - dropped right away instead of waiting
+    g_limitedX.clear();
+    REQUIRE(ThrowTouchMotion(pEventMgr, 3));
+    const auto dropped = pEventMgr->getLaneOverflow(event::EventLane::Low).dropped;
+    REQUIRE_FALSE(ThrowTouchMotion(pEventMgr, 4));
+    REQUIRE(pEventMgr->getLaneOverflow(event::EventLane::Low).dropped == dropped + 1);
+    pEventMgr->processEvents();
+    REQUIRE(g_limitedX == std::vector<int>{3});
+    // unlimited again
+    pEventMgr->setLaneCapacity(event::EventLane::Low, 0);
+    REQUIRE(pEventMgr->getLaneOverflow(event::EventLane::Low).capacity == 0);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+bool LimitedMotionCallback(event::EventCombined *event)
+{
+    g_limitedX.push_back(-event->mouse.relX);
+    return true;
+}
+
+TEST_CASE("Limited lane keeps the throw order", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    g_limitedX.clear();
+    REQUIRE(pEventMgr->addCallback(event::Type::TouchMotion, &LimitedTouchCallback) != nullptr);
+    REQUIRE(pEventMgr->addCallback(event::Type::MouseMotion, &LimitedMotionCallback) != nullptr);
+    REQUIRE(pEventMgr->setEventLane(event::Type::TouchMotion, event::EventLane::Low));
+    REQUIRE(pEventMgr->setEventLane(event::Type::MouseMotion, event::EventLane::Low));
+    pEventMgr->setCoalescePolicy(event::Type::MouseMotion, event::CoalescePolicy::AccumulateDeltas);
+    pEventMgr->setLaneCapacity(event::EventLane::Low, 8, event::OverflowPolicy::DropOldest);
+    // coalesced event is dispatched at the position of the first one, among limited events
+    ThrowTouchMotion(pEventMgr, 1);
+    ThrowTouchMotion(pEventMgr, 2);
+    for (int i = 0; i < 2; i++)
+    {
+        auto pEvent = reinterpret_cast<event::EventCombined *>(pEventMgr->requestEventStruct(event::Type::MouseMotion));
+        pEvent->mouse.pointerID = 0;
+        pEvent->mouse.pressed = false;
+        pEvent->mouse.relX = 5;
+        pEvent->mouse.relY = 0;
+        pEventMgr->throwEvent(event::Type::MouseMotion, pEvent);
+        ThrowTouchMotion(pEventMgr, 3 + i);
+    }
+    pEventMgr->processEvents();
+    REQUIRE(g_limitedX == std::vector<int>{1, 2, -10, 3, 4});
+    // events released by removing the limit stay ahead of the ones thrown afterwards
+    g_limitedX.clear();
+    ThrowTouchMotion(pEventMgr, 5);
+    pEventMgr->setLaneCapacity(event::EventLane::Low, 0);
+    ThrowTouchMotion(pEventMgr, 6);
+    pEventMgr->processEvents();
+    REQUIRE(g_limitedX == std::vector<int>{5, 6});
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+int g_spawnedCount = 0;
+int g_despawnedCount = 0;
+
+bool SpawnedCallback(event::EventCombined *event)
+{
+    g_spawnedCount++;
+    return true;
+}
+
+bool DespawnedCallback(event::EventCombined *event)
+{
+    g_despawnedCount++;
+    return true;
+}
+
+TEST_CASE("Registered custom event types get own dispatch slots", "[events]")
+{
+    auto pEventMgr = initializeEventManager();
+    auto spawned = pEventMgr->registerEventType("EntitySpawned");
+    auto despawned = pEventMgr->registerEventType("EntityDespawned");
+    REQUIRE(spawned != event::Type::Invalid);
+    REQUIRE(despawned != event::Type::Invalid);
+    REQUIRE(spawned != despawned);
+    REQUIRE(static_cast<unsigned int>(spawned) > static_cast<unsigned int>(event::Type::LastStandardEventCode));
+    REQUIRE(pEventMgr->registerEventType("EntitySpawned") == spawned);
+    REQUIRE(pEventMgr->registerEventType("ProgramInit") == event::Type::ProgramInit);
+    REQUIRE(pEventMgr->registerEventType("") == event::Type::Invalid);
+    REQUIRE(pEventMgr->findEventType("EntityDespawned") == despawned);
+    REQUIRE(pEventMgr->findEventType("EntityMissing") == event::Type::Invalid);
+    REQUIRE(pEventMgr->getEventTypeName(spawned) == "EntitySpawned");
+    REQUIRE(pEventMgr->getEventTypeName(event::Type::KeyDown) == "KeyDown");
+    REQUIRE(pEventMgr->isRegisteredEventType(despawned));
+    REQUIRE_FALSE(pEventMgr->isRegisteredEventType(event::Type::CustomEvent));
+    // each type reaches only its own callbacks
+    pEventMgr->addCallback(spawned, &SpawnedCallback);
+    pEventMgr->addCallback(despawned, &DespawnedCallback);
+    pEventMgr->throwEvent(spawned, pEventMgr->requestEventStruct(spawned));
+    pEventMgr->throwEvent(spawned);
+    pEventMgr->throwEvent(despawned);
+    pEventMgr->processEvents();
+    REQUIRE(g_spawnedCount == 2);
+    REQUIRE(g_despawnedCount == 1);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
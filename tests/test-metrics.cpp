@@ -0,0 +1,55 @@
+#include <catch2/catch.hpp>
+
+#include <util/Histogram.hpp>
+
+#include <thread>
+#include <vector>
+
+TEST_CASE("Histogram buckets and percentiles", "[metrics]")
+{
+    util::Histogram histogram;
+    REQUIRE(histogram.count() == 0);
+    REQUIRE(histogram.percentile(50.0) == 0);
+    // every value lands in a bucket that contains it
+    for (uint64_t value : {0ull, 1ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull})
+    {
+        const auto index = util::Histogram::bucketIndex(value);
+        REQUIRE(index < util::Histogram::NUM_BUCKETS);
+        REQUIRE(util::Histogram::bucketLowerBound(index) <= value);
+        REQUIRE(util::Histogram::bucketUpperBound(index) >= value);
+    }
+    for (uint64_t value = 1; value <= 1000; value++)
+        histogram.record(value);
+    REQUIRE(histogram.count() == 1000);
+    REQUIRE(histogram.min() == 1);
+    REQUIRE(histogram.max() == 1000);
+    REQUIRE(histogram.mean() == Approx(500.5));
+    // relative error is bounded by the bucket width
+    REQUIRE(histogram.percentile(50.0) >= 500);
+    REQUIRE(histogram.percentile(50.0) <= 500 * 107 / 100);
+    REQUIRE(histogram.percentile(99.0) >= 990);
+    REQUIRE(histogram.percentile(100.0) == 1000);
+    histogram.reset();
+    REQUIRE(histogram.count() == 0);
+    REQUIRE(histogram.max() == 0);
+}
+//!---------------------------------------------------------------------------------------
+
+TEST_CASE("Histogram records from many threads", "[metrics]")
+{
+    util::Histogram histogram;
+    std::vector<std::thread> threads;
+    for (int idx = 0; idx < 4; idx++)
+    {
+        threads.emplace_back([&histogram, idx]()
+                             {
+            for (uint64_t value = 0; value < 10000; value++)
+                histogram.record(value + idx); });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    REQUIRE(histogram.count() == 40000);
+    REQUIRE(histogram.min() == 0);
+    REQUIRE(histogram.max() == 10002);
+}
+//!---------------------------------------------------------------------------------------
@@ -0,0 +1,168 @@
+#include <catch2/catch.hpp>
+
+#include <util/SlabPool.hpp>
+#include <util/WorkerPool.hpp>
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+struct PooledValue
+{
+    int owner;
+    double payload;
+    PooledValue(int _owner) : owner(_owner), payload(0.0) {}
+};
+
+TEST_CASE("Slab pool ownership and recycling", "[pools]")
+{
+    util::SlabPool<PooledValue> pool;
+    std::vector<PooledValue *> values;
+    for (int idx = 0; idx < 1000; idx++)
+    {
+        auto pValue = pool.create(idx);
+        REQUIRE(pValue != nullptr);
+        REQUIRE(pool.owns(pValue));
+        values.push_back(pValue);
+    }
+    REQUIRE(std::set<PooledValue *>(values.begin(), values.end()).size() == values.size());
+    int local = 0;
+    REQUIRE(!pool.owns(&local));
+    REQUIRE(!pool.owns(reinterpret_cast<char *>(values[0]) + 1));
+    for (auto pValue : values)
+        REQUIRE(pool.destroy(pValue));
+    REQUIRE(!pool.destroy(values[0])); // double release is ignored
+    const auto capacity = pool.capacity();
+    for (int idx = 0; idx < 1000; idx++)
+        values[idx] = pool.create(idx);
+    REQUIRE(pool.capacity() == capacity);
+}
+//!---------------------------------------------------------------------------------------
+
+TEST_CASE("Slab pool used from multiple threads", "[pools]")
+{
+    util::SlabPool<PooledValue> pool;
+    std::atomic<int> errors(0);
+    std::vector<std::thread> threads;
+    for (int owner = 0; owner < 8; owner++)
+    {
+        threads.emplace_back([&pool, &errors, owner]()
+                             {
+            std::vector<PooledValue *> values;
+            for (int round = 0; round < 1000; round++)
+            {
+                for (int idx = 0; idx < 20; idx++)
+                    values.push_back(pool.create(owner));
+                for (auto pValue : values)
+                {
+                    if (!pValue || pValue->owner != owner || !pool.destroy(pValue))
+                        errors++;
+                }
+                values.clear();
+            } });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    REQUIRE(errors.load() == 0);
+}
+//!---------------------------------------------------------------------------------------
+
+TEST_CASE("Slab pool magazines evicted by other pools are returned", "[pools]")
+{
+    using Pool = util::SlabPool<PooledValue>;
+    Pool pool;
+    std::vector<PooledValue *> values;
+    for (std::size_t idx = 0; idx < Pool::NODES_PER_SLAB; idx++)
+        values.push_back(pool.create(0));
+    const auto capacity = pool.capacity();
+    for (auto pValue : values)
+        REQUIRE(pool.destroy(pValue));
+    // more pools than magazines - the cache of the first pool is evicted
+    std::vector<std::unique_ptr<Pool>> others;
+    for (std::size_t idx = 0; idx < Pool::MAX_THREAD_MAGAZINES * 2; idx++)
+    {
+        others.emplace_back(new Pool());
+        REQUIRE(others.back()->destroy(others.back()->create(1)));
+    }
+    // every slot is still available without growing
+    for (auto &pValue : values)
+        pValue = pool.create(2);
+    REQUIRE(pool.capacity() == capacity);
+    // magazines of destroyed pools are evicted safely
+    others.clear();
+    for (std::size_t idx = 0; idx < Pool::MAX_THREAD_MAGAZINES * 2; idx++)
+    {
+        Pool temporary;
+        REQUIRE(temporary.destroy(temporary.create(3)));
+    }
+    for (auto pValue : values)
+        REQUIRE(pool.destroy(pValue));
+}
+//!---------------------------------------------------------------------------------------
+
+TEST_CASE("Exhausted slab pool falls back to the heap", "[pools]")
+{
+    using SmallPool = util::SlabPool<PooledValue, 64>;
+    auto pPool = std::make_unique<SmallPool>();
+    const auto limit = SmallPool::MAX_SLABS * SmallPool::NODES_PER_SLAB;
+    std::vector<PooledValue *> values;
+    for (std::size_t idx = 0; idx < limit + 10; idx++)
+    {
+        auto pValue = pPool->create(static_cast<int>(idx));
+        REQUIRE(pValue != nullptr);
+        values.push_back(pValue);
+    }
+    REQUIRE(pPool->capacity() == limit);
+    REQUIRE(pPool->overflowCount() == 10);
+    REQUIRE(pPool->owns(values.back()));
+    REQUIRE(pPool->isAlive(values.back()));
+    REQUIRE(values.back()->owner == static_cast<int>(limit + 9));
+    for (auto pValue : values)
+        REQUIRE(pPool->destroy(pValue));
+    REQUIRE(pPool->overflowCount() == 0);
+    REQUIRE(!pPool->destroy(values.back())); // double release is ignored
+}
+//!---------------------------------------------------------------------------------------
+
+static util::WorkerPool g_workerPool;
+
+void AddTask(void *context, void *data)
+{
+    reinterpret_cast<std::atomic<int> *>(context)->fetch_add(1);
+}
+
+void SpawnTasks(void *context, void *data)
+{
+    // nested tasks go to the queue of the current worker, others may steal them
+    util::WorkerPool::WaitGroup group;
+    for (int idx = 0; idx < 10; idx++)
+        g_workerPool.submit(group, &AddTask, context, nullptr);
+    g_workerPool.wait(group);
+}
+
+TEST_CASE("Worker pool executes and joins task groups", "[pools]")
+{
+    std::atomic<int> counter(0);
+    REQUIRE(g_workerPool.start(4));
+    REQUIRE(g_workerPool.size() == 4);
+    for (int round = 0; round < 100; round++)
+    {
+        util::WorkerPool::WaitGroup group;
+        for (int idx = 0; idx < 20; idx++)
+            g_workerPool.submit(group, &AddTask, &counter, nullptr);
+        for (int idx = 0; idx < 4; idx++)
+            g_workerPool.submit(group, &SpawnTasks, &counter, nullptr);
+        g_workerPool.wait(group);
+        REQUIRE(group.done());
+        REQUIRE(counter.load() == (round + 1) * 60);
+    }
+    g_workerPool.stop();
+    REQUIRE_FALSE(g_workerPool.isRunning());
+    // not running - executed on the calling thread
+    util::WorkerPool::WaitGroup group;
+    g_workerPool.submit(group, &AddTask, &counter, nullptr);
+    REQUIRE(counter.load() == 6001);
+}
+//!---------------------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+#include <catch2/catch.hpp>
+#include <util/MpscQueue.hpp>
+
+#include <thread>
+#include <vector>
+#include <string>
+
+TEST_CASE("MPSC queue keeps per-producer order", "[queues]")
+{
+    const int numProducers = 4;
+    const int numValues = 5000;
+    // small ring - most of the values will go through the overflow path
+    util::MpscQueue<std::string> queue(16);
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < numProducers; producer++)
+    {
+        producers.emplace_back([&queue, producer, numValues]()
+                               {
+            for (int idx = 0; idx < numValues; idx++)
+                queue.push(std::to_string(producer * numValues + idx)); });
+    }
+    std::vector<int> last(numProducers, -1);
+    int total = 0;
+    bool ordered = true;
+    auto consume = [&](std::string &&value)
+    {
+        const int number = std::stoi(value);
+        const int producer = number / numValues;
+        const int idx = number % numValues;
+        if (idx <= last[producer])
+            ordered = false;
+        last[producer] = idx;
+        total++;
+    };
+    while (total < numProducers * numValues)
+        queue.drain(consume);
+    for (auto &thread : producers)
+        thread.join();
+    queue.drain(consume);
+    REQUIRE(ordered);
+    REQUIRE(total == numProducers * numValues);
+    REQUIRE(queue.empty());
+}
+//!---------------------------------------------------------------------------------------
+
+TEST_CASE("MPSC queue drain skips values pushed while draining", "[queues]")
+{
+    util::MpscQueue<int> queue(8);
+    for (int idx = 0; idx < 20; idx++)
+        queue.push(int(idx));
+    int drained = 0;
+    auto count = queue.drain([&](int &&value)
+                             {
+        drained++;
+        queue.push(value + 100); });
+    REQUIRE(count == 20);
+    REQUIRE(drained == 20);
+    REQUIRE(queue.size() == 20);
+}
+//!---------------------------------------------------------------------------------------
+
+TEST_CASE("MPSC queue batches are not interleaved", "[queues]")
+{
+    const int numProducers = 4;
+    const int numBatches = 500;
+    const int batchSize = 10;
+    util::MpscQueue<int> queue(64);
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < numProducers; producer++)
+    {
+        producers.emplace_back([&queue, producer, numBatches, batchSize]()
+                               {
+            std::vector<int> batch(batchSize);
+            for (int idx = 0; idx < numBatches; idx++)
+            {
+                for (int value = 0; value < batchSize; value++)
+                    batch[value] = (producer * numBatches + idx) * batchSize + value;
+                queue.pushBatch(batch.data(), batch.size());
+            } });
+    }
+    int total = 0;
+    int previous = -1;
+    bool contiguous = true;
+    auto consume = [&](int &&value)
+    {
+        // inside of a batch every value has to follow the previous one
+        if (value % batchSize != 0 && value != previous + 1)
+            contiguous = false;
+        previous = value;
+        total++;
+    };
+    while (total < numProducers * numBatches * batchSize)
+        queue.drain(consume);
+    for (auto &thread : producers)
+        thread.join();
+    REQUIRE(contiguous);
+    REQUIRE(queue.empty());
+    // batch larger than the ring goes through the overflow path as a whole
+    std::vector<int> large(100, 1);
+    REQUIRE_FALSE(queue.pushBatch(large.data(), large.size()));
+    REQUIRE(queue.size() == 100);
+}
+//!---------------------------------------------------------------------------------------
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <atomic>
 
 #include <util/Timesys.hpp>
 #include <util/FpsControl.hpp>
@@ -58,4 +59,248 @@ TEST_CASE("Trigger timers in fake loop", "[timers]")
     }
     destroyEventManager();
 }
-//!---------------------------------------------------------------------------------------
\ No newline at end of file
+//!---------------------------------------------------------------------------------------
+static std::vector<int> g_timerOrder;
+static uint32_t g_lateTimerId = 0;
+static event::EventManager *g_pTimersEventMgr = nullptr;
+
+bool orderedTimerFirst(void)
+{
+    g_timerOrder.push_back(1);
+    g_pTimersEventMgr->removeTimer(g_lateTimerId);
+    return true;
+}
+
+bool orderedTimerSecond(void)
+{
+    g_timerOrder.push_back(2);
+    return true;
+}
+
+bool orderedTimerLate(void)
+{
+    g_timerOrder.push_back(3);
+    return true;
+}
+
+TEST_CASE("Timers fire in deadline order and can be removed from callbacks", "[timers]")
+{
+    auto pEventMgr = initializeEventManager();
+    g_pTimersEventMgr = pEventMgr;
+    pEventMgr->addTimeout(40, &orderedTimerSecond);
+    pEventMgr->addTimeout(10, &orderedTimerFirst);
+    g_lateTimerId = pEventMgr->addTimeout(80, &orderedTimerLate);
+
+    const auto start = timesys::ticks();
+    while (timesys::ticks() - start < 150)
+    {
+        pEventMgr->processTimers();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(g_timerOrder.size() == 2);
+    REQUIRE(g_timerOrder[0] == 1);
+    REQUIRE(g_timerOrder[1] == 2);
+    REQUIRE(!pEventMgr->hasTimer(g_lateTimerId));
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+bool idleTimer(void)
+{
+    return true;
+}
+
+TEST_CASE("Cancel timers in bulk", "[timers]")
+{
+    auto pEventMgr = initializeEventManager();
+    std::vector<uint32_t> removed;
+    std::vector<uint32_t> kept;
+    for (int idx = 0; idx < 1000; idx++)
+    {
+        auto id = pEventMgr->addTimeout(60 * 1000, &idleTimer);
+        REQUIRE(id != 0);
+        if (idx % 10)
+            removed.push_back(id);
+        else
+            kept.push_back(id);
+    }
+    REQUIRE(pEventMgr->removeTimers(removed) == removed.size());
+    REQUIRE(pEventMgr->removeTimers(removed) == 0);
+    for (auto id : removed)
+        REQUIRE(!pEventMgr->hasTimer(id));
+    for (auto id : kept)
+        REQUIRE(pEventMgr->hasTimer(id));
+    // released slots are reused by new timers
+    auto id = pEventMgr->addTimeout(10, &idleTimer);
+    REQUIRE(pEventMgr->hasTimer(id));
+    REQUIRE(pEventMgr->removeTimer(id));
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static std::atomic<int64_t> g_preciseFiredTs(0);
+static std::atomic<int> g_handoffNotified(0);
+
+bool preciseTimer(void)
+{
+    g_preciseFiredTs = timesys::ticks();
+    return true;
+}
+
+void handoffNotify(void)
+{
+    g_handoffNotified++;
+}
+
+TEST_CASE("Timer thread fires without processTimers calls", "[timers]")
+{
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(pEventMgr->startTimerThread());
+    REQUIRE(pEventMgr->isTimerThreadRunning());
+    g_preciseFiredTs = 0;
+    const auto start = timesys::ticks();
+    pEventMgr->addTimeout(5, &preciseTimer);
+    while (!g_preciseFiredTs && timesys::ticks() - start < 1000)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    REQUIRE(g_preciseFiredTs >= start + 5);
+    pEventMgr->stopTimerThread();
+    REQUIRE(!pEventMgr->isTimerThreadRunning());
+
+    // handoff - expired timers wait for the owning thread
+    REQUIRE(pEventMgr->startTimerThread(event::TimerThreadMode::Handoff, &handoffNotify));
+    g_preciseFiredTs = 0;
+    pEventMgr->addTimeout(5, &preciseTimer);
+    const auto handoffStart = timesys::ticks();
+    while (!g_handoffNotified && timesys::ticks() - handoffStart < 1000)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    REQUIRE(g_handoffNotified == 1);
+    REQUIRE(g_preciseFiredTs == 0);
+    pEventMgr->processTimers();
+    REQUIRE(g_preciseFiredTs != 0);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+TEST_CASE("Timers with overlapping slack windows fire in one batch", "[timers]")
+{
+    event::TimerPool pool;
+    const auto baseTs = timesys::ticks();
+    for (int idx = 0; idx < 3; idx++)
+    {
+        auto timer = event::TimerHelper::function<event::TimerEntryInfo::TIMEOUT>(100 + idx * 10, &idleTimer);
+        timer.currentTs = baseTs;
+        timer.slack = 50;
+        REQUIRE(pool.insert(std::move(timer)) != 0);
+    }
+    auto tight = event::TimerHelper::function<event::TimerEntryInfo::TIMEOUT>(200, &idleTimer);
+    tight.currentTs = baseTs;
+    const auto tightId = pool.insert(std::move(tight));
+    // wake up at the latest time that satisfies the first window
+    REQUIRE(pool.nextDeadline() == baseTs + 150);
+    std::vector<uint32_t> fired;
+    pool.popExpired(baseTs + 150, [&fired](event::TimerEntryInfo &timer)
+                    { fired.push_back(timer.getId()); });
+    REQUIRE(fired.size() == 3);
+    REQUIRE(pool.nextDeadline() == baseTs + 200);
+    // slack change takes effect right away
+    REQUIRE(pool.find(tightId) != nullptr);
+    pool.find(tightId)->slack = 30;
+    REQUIRE(pool.refresh(tightId));
+    REQUIRE(pool.tombstones() == 1);
+    fired.clear();
+    pool.popExpired(baseTs + 199, [&fired](event::TimerEntryInfo &timer)
+                    { fired.push_back(timer.getId()); });
+    REQUIRE(fired.empty());
+    pool.popExpired(baseTs + 200, [&fired](event::TimerEntryInfo &timer)
+                    { fired.push_back(timer.getId()); });
+    REQUIRE(fired.size() == 1);
+    REQUIRE(fired[0] == tightId);
+}
+//!---------------------------------------------------------------------------------------
+
+static int g_fixedRateCalls = 0;
+
+bool slowInterval(void)
+{
+    if (!g_fixedRateCalls++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(70));
+    return true;
+}
+
+TEST_CASE("Fixed rate intervals keep to the original schedule", "[timers]")
+{
+    auto pEventMgr = initializeEventManager();
+    const auto id = pEventMgr->addInterval(20, &slowInterval);
+    REQUIRE(pEventMgr->setIntervalMode(id, event::IntervalMode::Skip));
+    const auto originTs = pEventMgr->getTimer(id)->currentTs;
+    const auto start = timesys::ticks();
+    while (timesys::ticks() - start < 200)
+    {
+        pEventMgr->processTimers();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(g_fixedRateCalls > 1);
+    // periods covered by the slow callback were dropped, no drift from the origin
+    REQUIRE(pEventMgr->getMissedPeriods(id) >= 2);
+    REQUIRE((pEventMgr->getTimer(id)->currentTs - originTs) % 20 == 0);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static int g_catchUpCalls = 0;
+
+bool slowCatchUpInterval(void)
+{
+    if (!g_catchUpCalls++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(70));
+    return true;
+}
+
+TEST_CASE("Catch up intervals fire the missed periods in a burst", "[timers]")
+{
+    auto pEventMgr = initializeEventManager();
+    const auto id = pEventMgr->addInterval(20, &slowCatchUpInterval);
+    REQUIRE(pEventMgr->setIntervalMode(id, event::IntervalMode::CatchUp));
+    const auto originTs = pEventMgr->getTimer(id)->currentTs;
+    while (!g_catchUpCalls)
+    {
+        pEventMgr->processTimers();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // the first call took more than three periods - the missed ones were fired in the
+    // same pass, the timer is back on schedule
+    REQUIRE(g_catchUpCalls >= 4);
+    REQUIRE(pEventMgr->getTimer(id)->getTargetTs() > timesys::ticks() - 20);
+    REQUIRE((pEventMgr->getTimer(id)->currentTs - originTs) % 20 == 0);
+    REQUIRE(pEventMgr->getMissedPeriods(id) >= 2);
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------
+
+static int g_burstFired = 0;
+
+bool burstTimer(void)
+{
+    g_burstFired++;
+    return true;
+}
+
+TEST_CASE("Expired timeouts are released in the same pass", "[timers]")
+{
+    auto pEventMgr = initializeEventManager();
+    REQUIRE(!pEventMgr->hasTimers());
+    std::vector<uint32_t> ids;
+    for (int idx = 0; idx < 2000; idx++)
+        ids.push_back(pEventMgr->addTimeout(1, &burstTimer));
+    auto kept = pEventMgr->addInterval(1, &burstTimer);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    pEventMgr->processTimers();
+    REQUIRE(g_burstFired == 2001);
+    for (auto id : ids)
+        REQUIRE(!pEventMgr->hasTimer(id));
+    REQUIRE(pEventMgr->hasTimer(kept));
+    REQUIRE(pEventMgr->removeTimer(kept));
+    REQUIRE(!pEventMgr->hasTimers());
+    destroyEventManager();
+}
+//!---------------------------------------------------------------------------------------